@@ -0,0 +1,117 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_AGGREGATOR_
+#define ROBOWFLEX_AGGREGATOR_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <robowflex_library/benchmarking.h>
+#include <robowflex_library/class_forward.h>
+#include <robowflex_library/statistics.h>
+
+namespace robowflex
+{
+    /** \cond IGNORE */
+    ROBOWFLEX_CLASS_FORWARD(StreamingAggregator);
+    /** \endcond */
+
+    /** \class robowflex::StreamingAggregatorPtr
+        \brief A shared pointer wrapper for robowflex::StreamingAggregator. */
+
+    /** \class robowflex::StreamingAggregatorConstPtr
+        \brief A const shared pointer wrapper for robowflex::StreamingAggregator. */
+
+    /** \brief Online summary statistics of benchmark results, updated as each run completes.
+     *  Runs are grouped by query name and planner. For the planning time and every numeric metric of a run,
+     *  streaming moments and quantile estimates are kept in constant memory per group, so summaries are
+     *  available while a long experiment is in progress. Attach to an experiment with
+     *  Experiment::setPostQueryCallback() and getCallback(). All methods are thread-safe.
+     */
+    class StreamingAggregator
+    {
+    public:
+        /** \brief Streaming summary of a single metric.
+         */
+        struct MetricSummary
+        {
+            stats::Moments moments;                    ///< Mean, variance, and range.
+            std::vector<stats::P2Quantile> quantiles;  ///< Quantile estimates.
+        };
+
+        /** \brief Streaming summary of the runs of a query and planner.
+         */
+        struct QuerySummary
+        {
+            std::size_t runs{0};                           ///< Number of runs.
+            std::size_t successes{0};                      ///< Number of successful runs.
+            std::map<std::string, MetricSummary> metrics;  ///< Summary of time and each numeric metric.
+
+            /** \brief Get the success rate of runs.
+             *  \return The success rate, or 0 if there are no runs.
+             */
+            double getSuccessRate() const;
+        };
+
+        /** \brief Constructor.
+         *  \param[in] quantiles Quantiles to estimate for each metric.
+         */
+        StreamingAggregator(const std::vector<double> &quantiles = {0.5, 0.9, 0.95, 0.99});
+
+        /** \brief Add a run to the summary of a group.
+         *  \param[in] key Name of the group, e.g., query and planner name.
+         *  \param[in] run Run to add.
+         */
+        void add(const std::string &key, const PlanData &run);
+
+        /** \brief Get a callback for Experiment::setPostQueryCallback() that adds each completed run.
+         *  Runs are grouped by query name, and planner ID if the query's request has one.
+         *  \return The callback.
+         */
+        Experiment::PostQueryCallback getCallback();
+
+        /** \brief Get a snapshot of all current summaries.
+         *  \return Map of group name to summary.
+         */
+        std::map<std::string, QuerySummary> getSummaries() const;
+
+        /** \brief Check if the mean of a metric has converged for a group, for early stopping. A metric has
+         *  converged if the half-width of its 95% confidence interval is within a tolerance relative to its
+         *  mean.
+         *  \param[in] key Name of the group.
+         *  \param[in] tolerance Relative tolerance on the confidence interval half-width.
+         *  \param[in] min_runs Minimum number of runs before a metric can be converged.
+         *  \param[in] metric Name of the metric.
+         *  \return True if the metric has converged.
+         */
+        bool hasConverged(const std::string &key, double tolerance, std::size_t min_runs = 10,
+                          const std::string &metric = "time") const;
+
+        /** \brief Log the current summaries.
+         */
+        void report() const;
+
+        /** \brief Write the current summaries to a JSON file. The file is replaced atomically, so it can be
+         *  polled by a live dashboard.
+         *  \param[in] file File to write to.
+         *  \return True on success, false on failure.
+         */
+        bool toJSONFile(const std::string &file) const;
+
+    private:
+        /** \brief Add a value to a metric of a summary.
+         *  \param[in] summary Summary to add to.
+         *  \param[in] metric Name of the metric.
+         *  \param[in] value Value to add.
+         */
+        void addValue(QuerySummary &summary, const std::string &metric, double value);
+
+        std::vector<double> quantiles_;                  ///< Quantiles to estimate.
+        std::map<std::string, QuerySummary> summaries_;  ///< Summaries of each group.
+        mutable std::mutex mutex_;                       ///< Mutex for summaries.
+    };
+}  // namespace robowflex
+
+#endif
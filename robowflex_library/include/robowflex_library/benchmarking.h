@@ -9,6 +9,7 @@
 #include <tuple>
 #include <map>
 #include <fstream>
+#include <thread>
 
 #include <boost/variant.hpp>
 
@@ -38,6 +39,12 @@ namespace robowflex
      */
     std::string toMetricString(const PlannerMetric &metric);
 
+    /** \brief Convert a planner metric into a double.
+     *  \param[in] metric The metric to convert.
+     *  \return The metric as a double, or NaN if the metric is a string that is not a number.
+     */
+    double toMetricDouble(const PlannerMetric &metric);
+
     /** \brief A container structure for all elements needed in a planning query, plus an identifying name.
      */
     struct PlanningQuery
@@ -117,10 +124,12 @@ namespace robowflex
          * progress properties. Will ignore a point if either value is non-finite.
          *  \param[in] xprop The property for the first coordinate.
          *  \param[in] yprop The property for the second coordinate.
+         *  \param[in] start Index of the first progress point to retrieve, e.g., to only get new points.
          *  \return A vector of the points.
          */
         std::vector<std::pair<double, double>> getProgressPropertiesAsPoints(const std::string &xprop,
-                                                                             const std::string &yprop) const;
+                                                                             const std::string &yprop,
+                                                                             std::size_t start = 0) const;
 
         /** \} */
     };
@@ -175,6 +184,8 @@ namespace robowflex
             \{ */
 
         std::map<std::string, std::vector<PlanDataPtr>> data;  ///< Map of query name to collected data.
+        PlanDataSetPtr warmup;  ///< Warm-up runs discarded from \a data, if any were requested through
+                                ///< Experiment::setWarmupRuns(). Can be output with any outputter.
 
         /** \brief Add a computed plan data under a query as a data point.
          *  \param[in] query_name Name of query to store point under.
@@ -222,6 +233,10 @@ namespace robowflex
             bool progress{true};           ///< If true, captures planner progress properties (if they exist).
             bool progress_at_least_once{true};  ///< If true, will always run the progress loop at least once.
             double progress_update_rate{0.1};   ///< Update rate for progress callbacks.
+            bool counters{false};  ///< If true, collects hardware performance counters and CPU time around
+                                   ///< the call to Planner::plan(). See robowflex::PerfCounters. Planning
+                                   ///< time is then measured over the same span, after progress properties
+                                   ///< are set up.
         };
 
         /** \brief Type for callback function that returns a metric over the results of a planning query.
@@ -424,6 +439,10 @@ namespace robowflex
          */
         const std::vector<PlanningQuery> &getQueries() const;
 
+        /** \brief Remove all queries from this experiment.
+         */
+        void clearQueries();
+
         /** \brief If called, will enable planners to use multiple threads. By default, planners are requested
          * to only use one thread.
          */
@@ -434,6 +453,14 @@ namespace robowflex
          */
         void overridePlanningTime();
 
+        /** \brief Set the number of warm-up runs done for each unique planner and scene pair before
+         * benchmarking. Warm-up runs include the cost of planner setup and context creation on first use, and
+         * are stored separately in PlanDataSet::warmup so they do not pollute steady-state metrics. The first
+         * warm-up run of each pair is its cold-start latency. By default, no warm-up runs are done.
+         *  \param[in] runs Number of warm-up runs per planner and scene pair.
+         */
+        void setWarmupRuns(std::size_t runs);
+
         /** \} */
 
         /** \name Callback Functions
@@ -482,6 +509,26 @@ namespace robowflex
         PlanDataSetPtr benchmark(std::size_t n_threads = 1) const;
 
     private:
+        /** \brief Run the planner's pre-run step and profile a single query.
+         *  The time taken by Planner::preRun() is stored in the metric "query_prerun_time".
+         *  \param[in] query Query to profile.
+         *  \param[in] time Allowed planning time for the request.
+         *  \param[in] callbacks If true, calls the pre-run callback before profiling.
+         *  \return The profiled data.
+         */
+        PlanDataPtr profileQuery(const PlanningQuery &query, double time, bool callbacks) const;
+
+        /** \brief Get the allowed planning time for a query, respecting overridePlanningTime().
+         *  \param[in] query Query to get planning time for.
+         *  \return The allowed planning time.
+         */
+        double getAllowedTime(const PlanningQuery &query) const;
+
+        /** \brief Do warm-up runs for each unique planner and scene pair.
+         *  \return The dataset of warm-up runs.
+         */
+        PlanDataSetPtr warmup() const;
+
         const std::string name_;  ///< Name of this experiment.
         double allowed_time_;     ///< Allotted time to use for each query.
         std::size_t trials_;      ///< Number of trials to run each query for.
@@ -491,6 +538,7 @@ namespace robowflex
                                              ///< thread.
         bool override_planning_time_{true};  ///< If true, will override request planning time with global
                                              ///< allowed time.
+        std::size_t warmup_runs_{0};         ///< Number of warm-up runs per planner and scene pair.
 
         Profiler::Options options_;           ///< Options for profiler.
         Profiler profiler_;                   ///< Profiler to use for extracting data.
@@ -518,6 +566,8 @@ namespace robowflex
     };
 
     /** \brief A benchmark outputter for storing data in a single JSON file.
+     *  Metric types are kept: booleans are written as `true` or `false`, doubles always have a decimal point
+     *  or exponent, and strings are quoted.
      */
     class JSONPlanDataSetOutputter : public PlanDataSetOutputter
     {
@@ -582,7 +632,8 @@ namespace robowflex
         ~OMPLPlanDataSetOutputter() override;
 
         /** \brief Dumps \a results into a OMPL benchmarking log file in \a prefix_ named after the request \a
-         *  name_.
+         *  name_. If runs have different metrics, the union of metrics is written, with missing values left
+         *  empty.
          *  \param[in] results Results to dump to file.
          */
         void dump(const PlanDataSet &results) override;
@@ -590,6 +641,72 @@ namespace robowflex
     private:
         const std::string prefix_;  ///< Log file prefix.
     };
+
+    /** \brief Loads datasets back from the log files written by JSONPlanDataSetOutputter and
+     *  OMPLPlanDataSetOutputter. Only what is stored in the logs is recovered: the query name, time, success,
+     *  metrics, and progress properties of each run. Scenes, planners, requests, and trajectories are not
+     *  available in loaded data.
+     */
+    class PlanDataSetLoader
+    {
+    public:
+        /** \brief Load all datasets from a JSON file written by JSONPlanDataSetOutputter.
+         *  Metric types are kept as written by JSONPlanDataSetOutputter. For older files, which do not keep
+         *  them, booleans are loaded as integers, and a metric that is a double in any run of a dataset is
+         *  loaded as a double in all its runs.
+         *  \param[in] file File to load.
+         *  \return The loaded datasets. Empty on failure.
+         */
+        static std::vector<PlanDataSetPtr> fromJSONFile(const std::string &file);
+
+        /** \brief Load a dataset from an OMPL benchmark log file written by OMPLPlanDataSetOutputter.
+         *  \param[in] file File to load.
+         *  \return The loaded dataset, or nullptr on failure.
+         */
+        static PlanDataSetPtr fromOMPLLogFile(const std::string &file);
+
+        /** \brief Load all datasets from a file, using fromJSONFile() if the file ends in `.json` and
+         *  fromOMPLLogFile() otherwise.
+         *  \param[in] file File to load.
+         *  \return The loaded datasets. Empty on failure.
+         */
+        static std::vector<PlanDataSetPtr> fromFile(const std::string &file);
+
+        /** \brief Load all datasets from many files in parallel.
+         *  \param[in] files Files to load, with fromFile().
+         *  \param[in] threads Number of threads to load with.
+         *  \return The loaded datasets, in the order of \a files.
+         */
+        static std::vector<PlanDataSetPtr>
+        fromFiles(const std::vector<std::string> &files,
+                  unsigned int threads = std::thread::hardware_concurrency());
+
+        /** \brief Merge the runs of many datasets into one. Runs of queries with the same name are merged
+         *  under that name. Timing and experiment parameters are combined over all datasets.
+         *  \param[in] datasets Datasets to merge.
+         *  \param[in] name Name of the merged dataset.
+         *  \return The merged dataset.
+         */
+        static PlanDataSetPtr merge(const std::vector<PlanDataSetPtr> &datasets, const std::string &name);
+
+        /** \brief Load many files in parallel, merge datasets with the same name, and dump the merged
+         *  datasets to an outputter. Files are loaded in batches of \a threads and merged as they are loaded,
+         *  so only one batch of files and the current shards are kept in memory. Note that each file is loaded
+         *  whole, and JSON files are first parsed into a YAML tree several times the size of the file, so
+         *  memory use is bounded by the largest files rather than by \a shard_size. Runs may have different
+         *  metrics, which are left missing in runs that do not have them.
+         *  \param[in] files Files to load, with fromFile().
+         *  \param[in] output Outputter to dump merged datasets to.
+         *  \param[in] shard_size If non-zero, a merged dataset is dumped as soon as it has this many runs, and
+         *  a new shard is started, so every shard but the last of each dataset has exactly this many runs.
+         *  Shards are named after their dataset with a `_shard<N>` suffix.
+         *  \param[in] threads Number of threads to load with.
+         *  \return The total number of runs dumped.
+         */
+        static std::size_t mergeFiles(const std::vector<std::string> &files, PlanDataSetOutputter &output,
+                                      std::size_t shard_size = 0,
+                                      unsigned int threads = std::thread::hardware_concurrency());
+    };
 }  // namespace robowflex
 
 #endif
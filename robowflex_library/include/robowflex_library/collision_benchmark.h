@@ -0,0 +1,136 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_COLLISION_BENCHMARK_
+#define ROBOWFLEX_COLLISION_BENCHMARK_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <moveit/robot_state/robot_state.h>
+
+#include <robowflex_library/class_forward.h>
+
+namespace robowflex
+{
+    /** \cond IGNORE */
+    ROBOWFLEX_CLASS_FORWARD(Robot);
+    ROBOWFLEX_CLASS_FORWARD(Scene);
+    ROBOWFLEX_CLASS_FORWARD(Trajectory);
+    ROBOWFLEX_CLASS_FORWARD(CollisionBenchmark);
+    /** \endcond */
+
+    /** \class robowflex::CollisionBenchmarkPtr
+        \brief A shared pointer wrapper for robowflex::CollisionBenchmark. */
+
+    /** \class robowflex::CollisionBenchmarkConstPtr
+        \brief A const shared pointer wrapper for robowflex::CollisionBenchmark. */
+
+    /** \brief Compares collision detector plugins (see Scene::setCollisionDetector()) on the same scenes.
+     *  Streams of states, either recorded from trajectories or sampled, are replayed against a copy of each
+     *  scene for every requested detector. Collision checking and distance query throughput are measured,
+     *  and results are compared against the first available detector to verify that backends agree.
+     */
+    class CollisionBenchmark
+    {
+    public:
+        /** \brief Results of replaying the states of one scene on one detector.
+         */
+        struct Result
+        {
+            std::string type;       ///< Type of the scene, used to group scenes for recommendations.
+            std::string scene;      ///< Name of the scene.
+            std::string detector;   ///< Name of the collision detector.
+            bool available{false};  ///< True if the detector could be loaded.
+
+            std::size_t states{0};      ///< Number of states replayed.
+            std::size_t collisions{0};  ///< Number of states in collision.
+            double check_time{0.};      ///< Total time spent checking collisions (s).
+            double distance_time{0.};   ///< Total time spent in distance queries (s).
+
+            std::size_t disagreements{0};   ///< Number of collision results that differ from the reference.
+            double max_distance_error{0.};  ///< Largest difference in distance from the reference.
+
+            /** \brief Get collision checking throughput.
+             *  \return States checked per second.
+             */
+            double getCheckRate() const;
+
+            /** \brief Get distance query throughput.
+             *  \return Distance queries per second.
+             */
+            double getDistanceRate() const;
+        };
+
+        /** \brief Constructor.
+         *  \param[in] detectors Names of collision detector plugins to compare. Detectors that cannot be
+         *  loaded are reported as unavailable.
+         */
+        CollisionBenchmark(const std::vector<std::string> &detectors = {"FCL", "Bullet", "Hybrid"});
+
+        /** \brief Add a scene and the states to replay in it.
+         *  \param[in] type Type of the scene. Recommendations are made per type.
+         *  \param[in] name Name of the scene.
+         *  \param[in] scene Scene to replay states in. This scene is copied, and not modified.
+         *  \param[in] states States to replay.
+         */
+        void addScene(const std::string &type, const std::string &name, const SceneConstPtr &scene,
+                      const std::vector<robot_state::RobotStatePtr> &states);
+
+        /** \brief Add a scene and replay the waypoints of a trajectory in it.
+         *  \param[in] type Type of the scene. Recommendations are made per type.
+         *  \param[in] name Name of the scene.
+         *  \param[in] scene Scene to replay states in. This scene is copied, and not modified.
+         *  \param[in] trajectory Trajectory whose waypoints are replayed.
+         */
+        void addScene(const std::string &type, const std::string &name, const SceneConstPtr &scene,
+                      const Trajectory &trajectory);
+
+        /** \brief Sample random states for a planning group.
+         *  \param[in] robot Robot to sample states for.
+         *  \param[in] group Planning group to sample.
+         *  \param[in] n Number of states to sample.
+         *  \param[in] seed Seed for the random number generator.
+         *  \return The sampled states.
+         */
+        static std::vector<robot_state::RobotStatePtr> sampleStates(const RobotConstPtr &robot,
+                                                                     const std::string &group, std::size_t n,
+                                                                     unsigned int seed = 0);
+
+        /** \brief Replay all scenes on all detectors.
+         *  \param[in] distance If true, also measure distance queries.
+         *  \return Results for each scene and detector.
+         */
+        std::vector<Result> run(bool distance = true) const;
+
+        /** \brief Recommend a detector for each scene type.
+         *  The recommended detector is the one with the highest collision checking throughput over all scenes
+         *  of a type, among those that agreed with the reference on every collision check.
+         *  \param[in] results Results from run().
+         *  \return Map of scene type to recommended detector name.
+         */
+        static std::map<std::string, std::string> recommend(const std::vector<Result> &results);
+
+        /** \brief Write results to a CSV file.
+         *  \param[in] results Results from run().
+         *  \param[in] file File to write to.
+         */
+        static void toCSVFile(const std::vector<Result> &results, const std::string &file);
+
+    private:
+        /** \brief A scene and its states to replay.
+         */
+        struct Entry
+        {
+            std::string type;                                ///< Type of the scene.
+            std::string name;                                ///< Name of the scene.
+            SceneConstPtr scene;                             ///< Scene.
+            std::vector<robot_state::RobotStatePtr> states;  ///< States to replay.
+        };
+
+        std::vector<std::string> detectors_;  ///< Detectors to compare.
+        std::vector<Entry> entries_;          ///< Scenes to replay.
+    };
+}  // namespace robowflex
+
+#endif
@@ -0,0 +1,106 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_COMPARE_
+#define ROBOWFLEX_COMPARE_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <robowflex_library/class_forward.h>
+#include <robowflex_library/statistics.h>
+
+namespace robowflex
+{
+    /** \cond IGNORE */
+    ROBOWFLEX_CLASS_FORWARD(PlanDataSet);
+    ROBOWFLEX_CLASS_FORWARD(PlanDataSetComparator);
+    /** \endcond */
+
+    /** \class robowflex::PlanDataSetComparatorPtr
+        \brief A shared pointer wrapper for robowflex::PlanDataSetComparator. */
+
+    /** \class robowflex::PlanDataSetComparatorConstPtr
+        \brief A const shared pointer wrapper for robowflex::PlanDataSetComparator. */
+
+    /** \brief Compares a baseline and candidate set of benchmark results for performance regressions.
+     *  Runs are matched by dataset name, query name, and planner. For each match, planning time (and any
+     *  other requested metrics) are compared with a Mann-Whitney U test, and success rates are compared with
+     *  a two-proportion z-test. A comparison is a regression if it is statistically significant and worse
+     *  than a configurable threshold.
+     */
+    class PlanDataSetComparator
+    {
+    public:
+        /** \brief Options for comparison.
+         */
+        struct Options
+        {
+            double alpha{0.05};              ///< Significance level of tests.
+            double time_threshold{0.1};      ///< Relative increase in median time that is a regression.
+            double success_threshold{0.05};  ///< Absolute drop in success rate that is a regression.
+            double metric_threshold{0.1};    ///< Relative change in median of other metrics that is a
+                                             ///< regression.
+
+            std::map<std::string, bool> metrics;  ///< Other metrics to compare over successful runs, mapped
+                                                  ///< to true if larger values are better.
+            std::string planner_metric{"request_planner_id"};  ///< Metric that identifies the planner of a
+                                                               ///< run. Not used if missing.
+        };
+
+        /** \brief Comparison of a metric between baseline and candidate runs.
+         */
+        struct Comparison
+        {
+            std::string key;             ///< Matched dataset, query, and planner.
+            std::string metric;          ///< Compared metric, "time", "success", or another metric.
+            std::size_t baseline_n{0};   ///< Number of baseline samples.
+            std::size_t candidate_n{0};  ///< Number of candidate samples.
+            double baseline{0.};         ///< Baseline median, or success rate.
+            double candidate{0.};        ///< Candidate median, or success rate.
+            double change{0.};           ///< Relative change in median, or absolute change in success rate.
+            stats::TestResult test;      ///< Result of the statistical test, with the candidate as the first
+                                         ///< sample.
+            bool significant{false};     ///< True if the test is significant.
+            bool regression{false};      ///< True if the change is a significant regression.
+        };
+
+        /** \brief Constructor. Uses the default options.
+         */
+        PlanDataSetComparator();
+
+        /** \brief Constructor.
+         *  \param[in] options Comparison options.
+         */
+        PlanDataSetComparator(const Options &options);
+
+        /** \brief Get the options for comparison.
+         *  \return A reference to the options.
+         */
+        Options &getOptions();
+
+        /** \brief Compare candidate datasets against baseline datasets.
+         *  \param[in] baseline Baseline datasets.
+         *  \param[in] candidate Candidate datasets.
+         *  \return A comparison for each matched query, planner, and metric.
+         */
+        std::vector<Comparison> compare(const std::vector<PlanDataSetPtr> &baseline,
+                                        const std::vector<PlanDataSetPtr> &candidate) const;
+
+        /** \brief Check if any comparison is a regression.
+         *  \param[in] comparisons Comparisons from compare().
+         *  \return True if any comparison is a regression.
+         */
+        static bool hasRegression(const std::vector<Comparison> &comparisons);
+
+        /** \brief Log a report of comparisons.
+         *  \param[in] comparisons Comparisons from compare().
+         */
+        static void report(const std::vector<Comparison> &comparisons);
+
+    private:
+        Options options_;  ///< Comparison options.
+    };
+}  // namespace robowflex
+
+#endif
@@ -0,0 +1,141 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_DATASET_
+#define ROBOWFLEX_DATASET_
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <robowflex_library/benchmarking.h>
+#include <robowflex_library/class_forward.h>
+#include <robowflex_library/pool.h>
+
+namespace robowflex
+{
+    /** \cond IGNORE */
+    ROBOWFLEX_CLASS_FORWARD(DatasetLoader);
+    /** \endcond */
+
+    /** \class robowflex::DatasetLoaderPtr
+        \brief A shared pointer wrapper for robowflex::DatasetLoader. */
+
+    /** \class robowflex::DatasetLoaderConstPtr
+        \brief A const shared pointer wrapper for robowflex::DatasetLoader. */
+
+    /** \brief Loads a dataset of scene and request pairs lazily for benchmarking.
+     *  Pairs are loaded and validated in parallel on a thread pool, a bounded number of pairs ahead of the
+     *  pair being used. Pairs are not kept by the loader once they are returned by next(), so only the
+     *  prefetched pairs and the pairs in use are in memory at a time. Benchmarking can start as soon as the
+     *  first pair is loaded.
+     */
+    class DatasetLoader
+    {
+    public:
+        /** \brief Files of a scene and request pair.
+         */
+        struct Entry
+        {
+            std::string name;          ///< Name of the pair.
+            std::string scene_file;    ///< Scene YAML file.
+            std::string request_file;  ///< Request YAML file.
+        };
+
+        /** \brief A loaded scene and request pair.
+         */
+        struct Item
+        {
+            std::string name;                 ///< Name of the pair.
+            ScenePtr scene;                   ///< Loaded scene.
+            MotionRequestBuilderPtr request;  ///< Loaded request.
+        };
+
+        /** \brief A callback function that is called on each pair after it is loaded, on a loading
+         *  thread. Can be used to configure requests or for additional validation.
+         *  \param[in,out] item The loaded pair.
+         *  \return True if the pair should be used, false if it should be skipped.
+         */
+        using ItemCallback = std::function<bool(Item &item)>;
+
+        /** \brief Constructor.
+         *  \param[in] robot Robot to load scenes with.
+         *  \param[in] planner Planner to load requests for.
+         *  \param[in] group Planning group of requests.
+         *  \param[in] threads Number of threads to load pairs with.
+         *  \param[in] prefetch Number of pairs to load ahead of the pair being used.
+         */
+        DatasetLoader(const RobotPtr &robot, const PlannerPtr &planner, const std::string &group,
+                      std::size_t threads = 4, std::size_t prefetch = 8);
+
+        /** \brief Add a scene and request pair.
+         *  \param[in] name Name of the pair.
+         *  \param[in] scene_file Scene YAML file.
+         *  \param[in] request_file Request YAML file.
+         */
+        void addEntry(const std::string &name, const std::string &scene_file,
+                      const std::string &request_file);
+
+        /** \brief Add all scene and request pairs in a directory. Scene files start with \a scene_prefix and
+         *  request files start with \a request_prefix. Files are paired by the number at the end of their
+         *  names, or by the rest of their names if there is no number, e.g., `scene_vicon0001.yaml` and
+         *  `request0001.yaml`. Pairs are named after the scene file and added in order.
+         *  \param[in] directory Directory to add pairs from.
+         *  \param[in] scene_prefix Prefix of scene files.
+         *  \param[in] request_prefix Prefix of request files.
+         *  \return The number of pairs added.
+         */
+        std::size_t addDirectory(const std::string &directory,               //
+                                 const std::string &scene_prefix = "scene",  //
+                                 const std::string &request_prefix = "request");
+
+        /** \brief Get the pairs added to the loader.
+         *  \return The added pairs.
+         */
+        const std::vector<Entry> &getEntries() const;
+
+        /** \brief Set a callback function that is called on each pair after it is loaded.
+         *  \param[in] callback Callback to use.
+         */
+        void setItemCallback(const ItemCallback &callback);
+
+        /** \brief Get the next pair that loaded successfully, waiting for it to load if needed. Pairs that
+         *  fail to load or validate are skipped.
+         *  \param[out] item The next pair.
+         *  \return True if a pair was returned, false if there are no more pairs.
+         */
+        bool next(Item &item);
+
+        /** \brief Benchmark each pair with an experiment, in order. For each pair, the experiment's queries
+         *  are replaced by a query for the pair, and the results are output with the pair's name appended to
+         *  the dataset's name. Only the results of one pair are in memory at a time.
+         *  \param[in] experiment Experiment to benchmark pairs with.
+         *  \param[in] output Outputter for results of each pair.
+         *  \param[in] n_threads Number of threads to use for benchmarking.
+         *  \return The number of pairs benchmarked.
+         */
+        std::size_t benchmark(Experiment &experiment, PlanDataSetOutputter &output,
+                              std::size_t n_threads = 1);
+
+    private:
+        /** \brief Load and validate a pair.
+         *  \param[in] entry Pair to load.
+         *  \return The loaded pair, or null on failure.
+         */
+        std::shared_ptr<Item> load(const Entry &entry) const;
+
+        RobotPtr robot_;              ///< Robot to load scenes with.
+        PlannerPtr planner_;          ///< Planner to load requests for.
+        const std::string group_;     ///< Planning group of requests.
+        const std::size_t prefetch_;  ///< Number of pairs to load ahead.
+
+        std::vector<Entry> entries_;  ///< Pairs to load.
+        std::size_t index_{0};        ///< Index of the next pair to start loading.
+        ItemCallback callback_;       ///< Callback on loaded pairs.
+
+        std::deque<std::shared_ptr<Pool::Job<std::shared_ptr<Item>>>> jobs_;  ///< Pairs being loaded.
+        Pool pool_;  ///< Thread pool to load pairs on.
+    };
+}  // namespace robowflex
+
+#endif
@@ -0,0 +1,119 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_GENERATOR_
+#define ROBOWFLEX_GENERATOR_
+
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <moveit/robot_state/robot_state.h>
+
+#include <robowflex_library/class_forward.h>
+#include <robowflex_library/geometry.h>
+
+namespace robowflex
+{
+    /** \cond IGNORE */
+    ROBOWFLEX_CLASS_FORWARD(Robot);
+    ROBOWFLEX_CLASS_FORWARD(Scene);
+    ROBOWFLEX_CLASS_FORWARD(MotionRequestBuilder);
+    ROBOWFLEX_CLASS_FORWARD(SceneGenerator);
+    /** \endcond */
+
+    /** \class robowflex::SceneGeneratorPtr
+        \brief A shared pointer wrapper for robowflex::SceneGenerator. */
+
+    /** \class robowflex::SceneGeneratorConstPtr
+        \brief A const shared pointer wrapper for robowflex::SceneGenerator. */
+
+    /** \brief Procedurally generates random scenes and motion planning requests for stress testing.
+     *  Scenes are populated with random primitive or mesh obstacles within a workspace. Every generated
+     *  request has a start and goal state that are collision-free (with optional clearance) in its scene.
+     *  Generation is deterministic given a seed, so datasets can be regenerated exactly, and independent of
+     *  the number of threads used.
+     */
+    class SceneGenerator
+    {
+    public:
+        /** \brief Options for scene generation.
+         */
+        struct Options
+        {
+            std::size_t obstacles{10};  ///< Number of obstacles to place. Ignored if \a density is positive.
+            double density{0.};  ///< Obstacles per cubic meter of workspace. If positive, overrides \a
+                                 ///< obstacles.
+
+            Eigen::Vector3d lower{-1., -1., 0.};         ///< Lower corner of the obstacle workspace.
+            Eigen::Vector3d upper{1., 1., 1.5};          ///< Upper corner of the obstacle workspace.
+            Eigen::Vector3d min_size{0.05, 0.05, 0.05};  ///< Minimum obstacle extents.
+            Eigen::Vector3d max_size{0.3, 0.3, 0.3};     ///< Maximum obstacle extents. For meshes, extents
+                                                         ///< are used as the mesh scale.
+
+            std::vector<Geometry::ShapeType::Type> shapes{
+                Geometry::ShapeType::BOX, Geometry::ShapeType::SPHERE,
+                Geometry::ShapeType::CYLINDER};  ///< Shape types to sample obstacles from.
+            std::vector<std::string> meshes;     ///< Mesh resources to sample from if MESH is in \a shapes.
+
+            double clearance{0.};  ///< Minimum distance from the start and goal states to any obstacle.
+            std::string tip;       ///< If not empty, the goal must place this link inside the workspace, so
+                                   ///< the goal is within the cluttered region.
+            std::size_t attempts{1000};  ///< Maximum attempts per obstacle and per sampled state.
+        };
+
+        /** \brief Constructor. Uses the default options.
+         *  \param[in] robot Robot to generate scenes and requests for.
+         *  \param[in] group Planning group to generate requests for.
+         */
+        SceneGenerator(const RobotConstPtr &robot, const std::string &group);
+
+        /** \brief Constructor.
+         *  \param[in] robot Robot to generate scenes and requests for.
+         *  \param[in] group Planning group to generate requests for.
+         *  \param[in] options Generation options.
+         */
+        SceneGenerator(const RobotConstPtr &robot, const std::string &group, const Options &options);
+
+        /** \brief Get the options for generation.
+         *  \return A reference to the options.
+         */
+        Options &getOptions();
+
+        /** \brief Generate a random scene and request.
+         *  \param[in] seed Seed for generation.
+         *  \param[out] scene Scene to populate with obstacles. Should be empty.
+         *  \param[out] request Request to set the start and goal state of.
+         *  \return True on success, false if no valid start and goal could be found.
+         */
+        bool generate(unsigned int seed, const ScenePtr &scene, MotionRequestBuilder &request) const;
+
+        /** \brief Add random obstacles to a scene that keep a set of states valid.
+         *  \param[in] seed Seed for generation.
+         *  \param[in,out] scene Scene to add obstacles to.
+         *  \param[in] states States that must remain valid (with clearance) after adding obstacles.
+         *  \return The number of obstacles added.
+         */
+        std::size_t addObstacles(unsigned int seed, const ScenePtr &scene,
+                                 const std::vector<robot_state::RobotStatePtr> &states) const;
+
+        /** \brief Generate many scene and request pairs in parallel and write them to YAML files.
+         *  Files are named `scene%04d.yaml` and `request%04d.yaml` (indexed from 1) in \a directory.
+         *  The pair with index `i` is generated with seed `seed + i`.
+         *  \param[in] directory Directory to write files to.
+         *  \param[in] count Number of pairs to generate.
+         *  \param[in] seed Base seed for generation.
+         *  \param[in] threads Number of threads to generate with.
+         *  \return The number of pairs successfully generated and written.
+         */
+        std::size_t generateToDirectory(const std::string &directory, std::size_t count,  //
+                                        unsigned int seed, unsigned int threads) const;
+
+    private:
+        RobotConstPtr robot_;  ///< Robot to generate for.
+        std::string group_;    ///< Planning group.
+        Options options_;      ///< Generation options.
+    };
+}  // namespace robowflex
+
+#endif
@@ -3,12 +3,19 @@
 #ifndef ROBOWFLEX_GEOMETRY_
 #define ROBOWFLEX_GEOMETRY_
 
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 
 #include <geometric_shapes/shapes.h>
 #include <geometric_shapes/bodies.h>
 
+#include <random_numbers/random_numbers.h>
+
 #include <shape_msgs/SolidPrimitive.h>
 #include <shape_msgs/Mesh.h>
 
@@ -23,6 +30,81 @@ namespace robowflex
     ROBOWFLEX_CLASS_FORWARD(Geometry);
     /** \endcond */
 
+    /** \brief A process-wide, thread-safe cache of mesh resources loaded by Geometry.
+     *  Loading a mesh reads and parses the file, and building its body computes a convex hull, both of which
+     *  are expensive. Meshes are cached by resolved resource path and scale, and are reloaded if the file's
+     *  modification time changes. Cached shapes are shared between all geometry (and so scenes) that load
+     *  the same resource, and must not be modified.
+     */
+    class MeshCache
+    {
+    public:
+        // non-copyable
+        MeshCache(MeshCache const &) = delete;
+        void operator=(MeshCache const &) = delete;
+
+        /** \brief A cached mesh.
+         */
+        struct Entry
+        {
+            std::string resource;       ///< Resolved resource path.
+            Eigen::Vector3d scale;      ///< Scale the mesh was loaded with.
+            std::time_t mtime{0};       ///< Modification time of the resource when loaded.
+            shapes::ShapePtr shape;     ///< Loaded mesh shape.
+            bodies::BodyConstPtr body;  ///< Body of the mesh, with its convex hull.
+        };
+
+        /** \brief Cache statistics.
+         */
+        struct Stats
+        {
+            std::size_t hits{0};     ///< Number of loads served from the cache.
+            std::size_t misses{0};   ///< Number of loads that read the resource.
+            std::size_t entries{0};  ///< Number of cached meshes.
+        };
+
+        /** \brief Get the singleton instance of MeshCache.
+         *  \return The singleton MeshCache.
+         */
+        static MeshCache &getInstance();
+
+        /** \brief Load a mesh through the cache.
+         *  \param[in] resource Resolved path to the mesh resource.
+         *  \param[in] scale Scale of the mesh.
+         *  \return The cached mesh. The shape and body are null on failure.
+         */
+        Entry load(const std::string &resource, const Eigen::Vector3d &scale);
+
+        /** \brief Find the cached mesh that owns a shape, e.g., one that was added to a scene.
+         *  \param[in] shape Shape to find.
+         *  \param[out] entry The cached mesh, if found.
+         *  \return True if the shape is a cached mesh, false otherwise.
+         */
+        bool find(const shapes::Shape *shape, Entry &entry) const;
+
+        /** \brief Get the current cache statistics.
+         *  \return The statistics.
+         */
+        Stats getStats() const;
+
+        /** \brief Remove all cached meshes and reset statistics. Geometry that uses a cached mesh keeps it.
+         */
+        void clear();
+
+    private:
+        /** \brief Constructor.
+         */
+        MeshCache() = default;
+
+        /** \brief Cache key, a resolved resource path and scale.
+         */
+        using Key = std::tuple<std::string, double, double, double>;
+
+        std::map<Key, Entry> entries_;  ///< Cached meshes.
+        Stats stats_;                   ///< Cache statistics.
+        mutable std::mutex mutex_;      ///< Mutex for cache.
+    };
+
     /** \class robowflex::GeometryPtr
         \brief A shared pointer wrapper for robowflex::Geometry. */
 
@@ -148,12 +230,53 @@ namespace robowflex
          */
         bool contains(const Eigen::Vector3d &point) const;
 
-        /** \brief Tries to sample a point in the geometry.
+        /** \brief A mask of which points in a batch are contained by the geometry.
+         */
+        using ContainsMask = Eigen::Array<bool, Eigen::Dynamic, 1>;
+
+        /** \brief Checks which of a batch of points the geometry contains. Boxes, spheres, and cylinders are
+         *  checked with vectorized kernels, and points outside a mesh's bounding sphere are culled before
+         *  checking the mesh.
+         *  \param[in] points The points to check as columns, in the geometry's frame.
+         *  \param[out] mask For each point, true if the geometry contains the point.
+         *  \return The number of points the geometry contains.
+         */
+        std::size_t contains(const Eigen::Matrix3Xd &points, ContainsMask &mask) const;
+
+        /** \brief Tries to sample a point in the geometry, using a thread-local random number generator.
          *  \param[in] attempts Number of attempts to sample.
          *  \return The sampled point and true, or the 0 vector and false on failure.
          */
         std::pair<bool, Eigen::Vector3d> sample(const unsigned int attempts = 50) const;
 
+        /** \brief Tries to sample a point in the geometry.
+         *  \param[in,out] rng Random number generator to sample with.
+         *  \param[in] attempts Number of attempts to sample.
+         *  \return The sampled point and true, or the 0 vector and false on failure.
+         */
+        std::pair<bool, Eigen::Vector3d> sample(random_numbers::RandomNumberGenerator &rng,
+                                                const unsigned int attempts = 50) const;
+
+        /** \brief Samples a batch of points in the geometry. Boxes, spheres, and cylinders are sampled by
+         *  vectorized rejection sampling from their bounding box.
+         *  \param[in] n Number of points to sample.
+         *  \param[out] points The sampled points as columns. Resized to the number of sampled points.
+         *  \param[in,out] rng Random number generator to sample with.
+         *  \param[in] attempts Number of attempts to sample per point.
+         *  \return The number of sampled points, which is less than \a n if attempts ran out.
+         */
+        std::size_t sample(std::size_t n, Eigen::Matrix3Xd &points,
+                           random_numbers::RandomNumberGenerator &rng,  //
+                           const unsigned int attempts = 50) const;
+
+        /** \brief Samples a batch of points in the geometry, using a thread-local random number generator.
+         *  \param[in] n Number of points to sample.
+         *  \param[out] points The sampled points as columns. Resized to the number of sampled points.
+         *  \param[in] attempts Number of attempts to sample per point.
+         *  \return The number of sampled points, which is less than \a n if attempts ran out.
+         */
+        std::size_t sample(std::size_t n, Eigen::Matrix3Xd &points, const unsigned int attempts = 50) const;
+
         /** \brief Checks if the geometry is a mesh geometry.
          *  \return True if the \a type_ is a mesh (ShapeType::MESH).
          */
@@ -169,7 +292,8 @@ namespace robowflex
          */
         const shape_msgs::Mesh getMeshMsg() const;
 
-        /** \brief Gets the underlying shape.
+        /** \brief Gets the underlying shape. Meshes loaded from a resource share their shape through the
+         *  MeshCache, and must not be modified.
          *  \return The shape.
          */
         const shapes::ShapePtr &getShape() const;
@@ -211,6 +335,25 @@ namespace robowflex
          */
         shapes::Shape *loadShape() const;
 
+        /** \brief Gets the half extents of the body of a box, sphere, or cylinder, including scale and
+         *  padding.
+         *  \param[out] half The half extents along x, y, z.
+         *  \return True if the geometry is a box, sphere, or cylinder, false otherwise.
+         */
+        bool getPrimitiveExtents(Eigen::Vector3d &half) const;
+
+        /** \brief Checks which of a batch of points a box, sphere, or cylinder contains.
+         *  \param[in] local The points to check as columns, in the body's frame.
+         *  \param[in] half The half extents from getPrimitiveExtents().
+         *  \return For each point, true if the primitive contains the point.
+         */
+        ContainsMask containsPrimitive(const Eigen::Matrix3Xd &local, const Eigen::Vector3d &half) const;
+
+        /** \brief Uses a mesh from the MeshCache for \a shape_ and \a body_.
+         *  \param[in] entry The cached mesh.
+         */
+        void useCachedMesh(const MeshCache::Entry &entry);
+
         /** \brief Loads a body from the loaded \a shape_.
          *  \return A pointer to a newly allocated body.
          */
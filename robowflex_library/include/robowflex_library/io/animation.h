@@ -0,0 +1,150 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_IO_ANIMATION_
+#define ROBOWFLEX_IO_ANIMATION_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <geometry_msgs/Pose.h>
+
+#include <robowflex_library/adapter.h>
+
+namespace robowflex
+{
+    namespace IO
+    {
+        /** \brief Writes link transforms of an animated robot to a compact binary file, one frame at a time.
+         *  A file has a header with the frames per second and a table of link names, followed by frames.
+         *  Each frame has a duration and, for each link, a pose as seven single precision floats (position,
+         *  then orientation quaternion as x, y, z, w), in the order of the link table. Values are written in
+         *  native byte order. To further reduce file size, frames between keyframes can be stored as
+         *  deltas, which only contain the poses of links that moved since the previous frame. Frames are
+         *  written as they are added, so memory use is constant in the length of the animation. Read with
+         *  robowflex::IO::AnimationReader.
+         */
+        class AnimationWriter
+        {
+        public:
+            /** \brief Constructor. Creates the file and writes the header.
+             *  \param[in] filename File to write to.
+             *  \param[in] links Names of links in the animation.
+             *  \param[in] fps Frames per second of the animation.
+             *  \param[in] keyframe_interval Number of frames from one keyframe to the next. Frames in between
+             *  are deltas. If 0 or 1, all frames are keyframes.
+             *  \param[in] tolerance Maximum change in any value of a link's pose for the link to be
+             *  considered unmoved in a delta.
+             */
+            AnimationWriter(const std::string &filename, const std::vector<std::string> &links, double fps,
+                            std::size_t keyframe_interval = 0, double tolerance = 1e-6);
+
+            /** \brief Destructor. Closes the file.
+             */
+            ~AnimationWriter();
+
+            // non-copyable
+            AnimationWriter(AnimationWriter const &) = delete;
+            void operator=(AnimationWriter const &) = delete;
+
+            /** \brief Returns true if the file is open and no writes have failed.
+             *  \return True if the file is writable, false otherwise.
+             */
+            bool isOpen() const;
+
+            /** \brief Write a frame.
+             *  \param[in] duration Duration since the previous frame.
+             *  \param[in] poses Pose of each link, in the order given to the constructor.
+             *  \return True on success, false on failure.
+             */
+            bool addFrame(double duration, const RobotPoseVector &poses);
+
+            /** \brief Get the number of frames written.
+             *  \return The number of frames written.
+             */
+            std::size_t getFrameCount() const;
+
+            /** \brief Close the file.
+             *  \return True if all writes succeeded, false otherwise.
+             */
+            bool close();
+
+        private:
+            std::ofstream out_;                    ///< Output file.
+            const std::size_t links_;              ///< Number of links.
+            const std::size_t keyframe_interval_;  ///< Number of frames between keyframes.
+            const float tolerance_;                ///< Tolerance for a link to be unmoved.
+            std::size_t frames_{0};                ///< Number of frames written.
+            std::vector<float> previous_;          ///< Values of the previous frame, as read back.
+            std::vector<float> current_;           ///< Values of the frame being written.
+            std::vector<uint8_t> mask_;            ///< Bitmask of links moved in a delta frame.
+        };
+
+        /** \brief Reads link transforms of an animated robot from a file written by
+         *  robowflex::IO::AnimationWriter, one frame at a time.
+         */
+        class AnimationReader
+        {
+        public:
+            /** \brief Constructor. Opens the file and reads the header.
+             *  \param[in] filename File to read.
+             */
+            AnimationReader(const std::string &filename);
+
+            // non-copyable
+            AnimationReader(AnimationReader const &) = delete;
+            void operator=(AnimationReader const &) = delete;
+
+            /** \brief Returns true if the file was opened and has a valid header.
+             *  \return True if the file is readable, false otherwise.
+             */
+            bool isOpen() const;
+
+            /** \brief Get the frames per second of the animation.
+             *  \return The frames per second.
+             */
+            double getFPS() const;
+
+            /** \brief Get the names of the links in the animation.
+             *  \return The link names.
+             */
+            const std::vector<std::string> &getLinks() const;
+
+            /** \brief Read the next frame.
+             *  \param[out] duration Duration since the previous frame.
+             *  \return True if a frame was read, false at the end of the file or on failure.
+             */
+            bool next(double &duration);
+
+            /** \brief Get the pose of a link in the last frame read.
+             *  \param[in] index Index of the link in getLinks().
+             *  \return The pose of the link.
+             */
+            RobotPose getPose(std::size_t index) const;
+
+            /** \brief Get the pose of a link in the last frame read as a message.
+             *  \param[in] index Index of the link in getLinks().
+             *  \return The pose of the link.
+             */
+            geometry_msgs::Pose getPoseMsg(std::size_t index) const;
+
+            /** \brief Convert the remaining frames to the YAML format written by
+             *  robowflex::Robot::dumpPathTransforms().
+             *  \param[in] filename YAML file to write.
+             *  \return True on success, false on failure.
+             */
+            bool toYAMLFile(const std::string &filename);
+
+        private:
+            std::ifstream in_;                ///< Input file.
+            bool valid_{false};               ///< True if the header was read.
+            double fps_{0};                   ///< Frames per second.
+            std::vector<std::string> links_;  ///< Link names.
+            std::vector<float> frame_;        ///< Values of the last frame read.
+            std::vector<uint8_t> mask_;       ///< Bitmask of links moved in a delta frame.
+        };
+    }  // namespace IO
+}  // namespace robowflex
+
+#endif
@@ -3,6 +3,14 @@
 #ifndef ROBOWFLEX_IO_BAG_
 #define ROBOWFLEX_IO_BAG_
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include <robowflex_library/macros.h>
 
 // clang-format off
@@ -30,34 +38,92 @@ namespace robowflex
                 WRITE  ///< Write-only
             };
 
+            /** \brief Options for writing a bag asynchronously.
+             */
+            struct WriterOptions
+            {
+                std::size_t queue_size{1024};     ///< Maximum number of messages waiting to be written.
+                bool block{false};                ///< If true, adding a message to a full queue waits for
+                                                  ///< space. Otherwise, the message is dropped.
+                uint32_t chunk_size{768 * 1024};  ///< Size in bytes of bag chunks.
+                rosbag::CompressionType compression{rosbag::compression::Uncompressed};  ///< Compression.
+            };
+
+            /** \brief Statistics of an asynchronously written bag.
+             */
+            struct WriterStats
+            {
+                std::size_t written{0};        ///< Number of messages written.
+                std::size_t dropped{0};        ///< Number of messages dropped as the queue was full.
+                std::size_t backpressured{0};  ///< Number of messages that waited for space in the queue.
+                std::size_t failed{0};         ///< Number of messages not written after a write error.
+            };
+
             /** \brief Constructor.
              *  \param[in] file File to open or create.
              *  \param[in] mode Mode to open file in.
              */
             Bag(const std::string &file, Mode mode = WRITE);
 
+            /** \brief Constructor. Opens a bag for asynchronous writing. Added messages are queued and
+             *  written on a background thread, so adding a message does not wait on disk I/O. The writer
+             *  takes the whole queue at once, so up to twice WriterOptions::queue_size messages may be held
+             *  in memory: a full queue and the batch being written. If a write fails (e.g., the disk is
+             *  full), writing stops, and the messages not written are counted in WriterStats::failed.
+             *  \param[in] file File to create.
+             *  \param[in] options Options for writing.
+             */
+            Bag(const std::string &file, const WriterOptions &options);
+
             /** \brief Destructor.
-             *  Closes opened bag.
+             *  Writes any queued messages and closes opened bag.
              */
             ~Bag();
 
-            /** \brief Adds a message to the bag under \a topic.
+            /** \brief Adds a message to the bag under \a topic, timestamped with the current time.
              *  \param[in] topic Topic to save message under.
              *  \param[in] msg Message to write.
              *  \tparam T Type of message.
+             *  \return True if the message was written or queued, false otherwise.
              */
             template <typename T>
             bool addMessage(const std::string &topic, const T &msg)
             {
-                if (mode_ == WRITE)
+                return addMessage(topic, msg, ros::Time::now());
+            }
+
+            /** \brief Adds a message to the bag under \a topic.
+             *  \param[in] topic Topic to save message under.
+             *  \param[in] msg Message to write.
+             *  \param[in] time Time to save message at.
+             *  \tparam T Type of message.
+             *  \return True if the message was written or queued, false otherwise.
+             */
+            template <typename T>
+            bool addMessage(const std::string &topic, const T &msg, const ros::Time &time)
+            {
+                if (mode_ != WRITE)
+                    return false;
+
+                if (not thread_.joinable())
                 {
-                    bag_.write(topic, ros::Time::now(), msg);
+                    bag_.write(topic, time, msg);
                     return true;
                 }
 
-                return false;
+                return enqueue([this, topic, msg, time] { bag_.write(topic, time, msg); });
             }
 
+            /** \brief Waits until all queued messages have been written. Does nothing if the bag is not
+             *  written asynchronously.
+             */
+            void flush();
+
+            /** \brief Get statistics of asynchronous writing.
+             *  \return The writer statistics.
+             */
+            WriterStats getWriterStats() const;
+
             /** \brief Gets messages from an opened bag. Returns all messages of type \a T from a list of
              *  topics \a topics.
              *  \param[in] topics List of topics to load messages from.
@@ -71,21 +137,261 @@ namespace robowflex
                 if (mode_ != READ)
                     return msgs;
 
-                rosbag::View view(bag_, rosbag::TopicQuery(topics));
-                for (auto &msg : view)
-                {
-                    typename T::ConstPtr ptr = msg.instantiate<T>();
-                    if (ptr != nullptr)
-                        msgs.emplace_back(*ptr);
-                }
+                Stream<T> stream(*this, topics);
+                for (const auto &msg : stream)
+                    msgs.emplace_back(*msg.msg);
 
                 return msgs;
             }
 
+            /** \brief A lazy stream over the messages of type \a T in an opened bag. Messages are only
+             *  decoded when the stream reaches them, so a bag of any size can be processed in constant
+             *  memory:
+             *
+             *      IO::Bag bag("scenes.bag", IO::Bag::READ);
+             *      IO::Bag::Stream<moveit_msgs::PlanningScene> stream(bag, {"scene"});
+             *      for (const auto &message : stream)
+             *          process(*message.msg);
+             *
+             *  Optionally, messages can be read ahead and decoded on a background thread, overlapping
+             *  decoding with processing. At most \a read_ahead decoded messages are held at a time.
+             *  A stream can only be iterated over once, and the bag should not be read by anything
+             *  else while the stream is in use.
+             *  \tparam T Type of messages to stream. Messages of other types are skipped.
+             */
+            template <typename T>
+            class Stream
+            {
+            public:
+                /** \brief A message read from the bag.
+                 */
+                struct Message
+                {
+                    std::string topic;         ///< Topic the message was recorded on.
+                    ros::Time time;            ///< Time the message was recorded at.
+                    typename T::ConstPtr msg;  ///< The decoded message.
+                };
+
+                /** \brief Input iterator over a stream.
+                 */
+                class Iterator
+                {
+                public:
+                    using iterator_category = std::input_iterator_tag;
+                    using value_type = Message;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = const Message *;
+                    using reference = const Message &;
+
+                    /** \brief Constructor. Reads the first message of the stream.
+                     *  \param[in] stream Stream to iterate over. If null, is the end iterator.
+                     */
+                    Iterator(Stream *stream = nullptr) : stream_(stream)
+                    {
+                        ++(*this);
+                    }
+
+                    reference operator*() const
+                    {
+                        return message_;
+                    }
+
+                    pointer operator->() const
+                    {
+                        return &message_;
+                    }
+
+                    Iterator &operator++()
+                    {
+                        if (stream_ and not stream_->next(message_))
+                            stream_ = nullptr;
+
+                        return *this;
+                    }
+
+                    bool operator==(const Iterator &other) const
+                    {
+                        return stream_ == other.stream_;
+                    }
+
+                    bool operator!=(const Iterator &other) const
+                    {
+                        return not(*this == other);
+                    }
+
+                private:
+                    Stream *stream_;   ///< Stream iterated over, or null at the end.
+                    Message message_;  ///< Current message.
+                };
+
+                /** \brief Constructor.
+                 *  \param[in] bag Bag to stream messages from. Must be opened in READ mode.
+                 *  \param[in] topics Topics to stream messages from. If empty, all topics are streamed.
+                 *  \param[in] start Only stream messages recorded at or after this time.
+                 *  \param[in] end Only stream messages recorded at or before this time.
+                 *  \param[in] read_ahead If non-zero, the number of messages to read ahead on a background
+                 *  thread.
+                 */
+                Stream(Bag &bag, const std::vector<std::string> &topics,  //
+                       const ros::Time &start = ros::TIME_MIN,            //
+                       const ros::Time &end = ros::TIME_MAX,              //
+                       std::size_t read_ahead = 0)
+                  : read_ahead_(read_ahead)
+                {
+                    if (bag.mode_ != READ)
+                        return;
+
+                    if (topics.empty())
+                        view_.reset(new rosbag::View(bag.bag_, start, end));
+                    else
+                        view_.reset(new rosbag::View(bag.bag_, rosbag::TopicQuery(topics), start, end));
+
+                    it_ = view_->begin();
+                    if (read_ahead_)
+                        thread_ = std::thread([this] { readAhead(); });
+                }
+
+                /** \brief Destructor. Stops reading ahead.
+                 */
+                ~Stream()
+                {
+                    if (thread_.joinable())
+                    {
+                        {
+                            std::unique_lock<std::mutex> lock(mutex_);
+                            stop_ = true;
+                        }
+
+                        cv_.notify_all();
+                        thread_.join();
+                    }
+                }
+
+                // non-copyable
+                Stream(Stream const &) = delete;
+                void operator=(Stream const &) = delete;
+
+                /** \brief Get the next message in the stream.
+                 *  \param[out] message The next message.
+                 *  \return True if a message was read, false at the end of the stream.
+                 */
+                bool next(Message &message)
+                {
+                    if (not view_)
+                        return false;
+
+                    if (not read_ahead_)
+                        return decode(message);
+
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    cv_.wait(lock, [&] { return not queue_.empty() or done_; });
+                    if (queue_.empty())
+                        return false;
+
+                    message = std::move(queue_.front());
+                    queue_.pop_front();
+
+                    cv_.notify_all();
+                    return true;
+                }
+
+                /** \brief Get an iterator to the first message. Can only be called once.
+                 *  \return An iterator to the first message.
+                 */
+                Iterator begin()
+                {
+                    return Iterator(this);
+                }
+
+                /** \brief Get an iterator past the last message.
+                 *  \return The end iterator.
+                 */
+                Iterator end()
+                {
+                    return Iterator();
+                }
+
+            private:
+                /** \brief Decode the next message of type \a T from the view.
+                 *  \param[out] message The next message.
+                 *  \return True if a message was decoded, false at the end of the view.
+                 */
+                bool decode(Message &message)
+                {
+                    for (; it_ != view_->end(); ++it_)
+                    {
+                        typename T::ConstPtr ptr = it_->template instantiate<T>();
+                        if (ptr != nullptr)
+                        {
+                            message.topic = it_->getTopic();
+                            message.time = it_->getTime();
+                            message.msg = ptr;
+
+                            ++it_;
+                            return true;
+                        }
+                    }
+
+                    return false;
+                }
+
+                /** \brief Decode messages into the queue until the view is exhausted or the stream is
+                 *  destroyed. Run on the read-ahead thread.
+                 */
+                void readAhead()
+                {
+                    Message message;
+                    while (decode(message))
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        cv_.wait(lock, [&] { return queue_.size() < read_ahead_ or stop_; });
+                        if (stop_)
+                            break;
+
+                        queue_.emplace_back(std::move(message));
+                        cv_.notify_all();
+                    }
+
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    done_ = true;
+                    cv_.notify_all();
+                }
+
+                const std::size_t read_ahead_;        ///< Number of messages to read ahead.
+                std::unique_ptr<rosbag::View> view_;  ///< View of the bag.
+                rosbag::View::iterator it_;           ///< Next message in the view.
+                std::deque<Message> queue_;           ///< Messages read ahead.
+                bool done_{false};                    ///< True if the read-ahead thread is done.
+                bool stop_{false};                    ///< True if the read-ahead thread should stop.
+                std::mutex mutex_;                    ///< Mutex for the read-ahead queue.
+                std::condition_variable cv_;          ///< Notified when the queue changes.
+                std::thread thread_;                  ///< Read-ahead thread.
+            };
+
         private:
+            /** \brief Queue a write for the writer thread.
+             *  \param[in] write Function that writes a message to the bag.
+             *  \return True if the write was queued, false if it was dropped.
+             */
+            bool enqueue(std::function<void()> &&write);
+
+            /** \brief Write queued messages until the bag is destroyed. Run on the writer thread.
+             */
+            void run();
+
             const Mode mode_;         ///< Mode to open file in.
             const std::string file_;  ///< File opened.
             rosbag::Bag bag_;         ///< `rosbag` opened.
+
+            WriterOptions options_;                    ///< Options for asynchronous writing.
+            WriterStats stats_;                        ///< Statistics of asynchronous writing.
+            std::deque<std::function<void()>> queue_;  ///< Queued writes.
+            std::size_t active_{0};                    ///< Number of writes being performed.
+            bool done_{false};                         ///< True if the writer thread should stop.
+            bool failed_{false};                       ///< True if writing failed.
+            mutable std::mutex mutex_;                 ///< Mutex for the queue and statistics.
+            std::condition_variable cv_;               ///< Notified when the queue changes.
+            std::thread thread_;                       ///< Writer thread.
         };
     }  // namespace IO
 }  // namespace robowflex
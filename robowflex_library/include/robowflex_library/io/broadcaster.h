@@ -3,8 +3,13 @@
 #ifndef ROBOWFLEX_IO_ROBOTBROADCASTER_
 #define ROBOWFLEX_IO_ROBOTBROADCASTER_
 
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <thread>
 
+#include <geometry_msgs/TransformStamped.h>
+
 #include <robowflex_library/class_forward.h>
 #include <robowflex_library/adapter.h>
 #include <tf2_ros/transform_broadcaster.h>
@@ -18,11 +23,39 @@ namespace robowflex
 
     namespace IO
     {
-        /** \brief Helper class to broadcast transform information on TF and joint states
+        /** \brief Helper class to broadcast transform information on TF and joint states.
+         *  Each update, transforms are only sent if some link moved since they were last sent, and then all
+         *  of them are sent as a single batch. TF only looks up a frame at a time every transform on its
+         *  chain is known at, so sending only the moved links would hold lookups through the rest back to
+         *  when those were last sent. While the robot is still, nothing is sent, so the latest transforms
+         *  are as old as the last motion or the keep alive period (see setKeepAlive()), after which all
+         *  transforms are sent again so that late listeners and listener buffers stay up to date. Lookups
+         *  at the latest time are unaffected, but lookups at the current time wait for the next send; a
+         *  shorter period bounds that wait at the cost of sending more. Static transforms are published
+         *  once on a latched topic whenever they change.
          */
         class RobotBroadcaster
         {
         public:
+            /** \brief A function that sends a batch of transforms.
+             *  \param[in] transforms Transforms to send.
+             */
+            using TransformPublisher =
+                std::function<void(const std::vector<geometry_msgs::TransformStamped> &transforms)>;
+
+            /** \brief Statistics on published transforms.
+             */
+            struct Stats
+            {
+                std::size_t updates{0};         ///< Number of updates.
+                std::size_t batches{0};         ///< Number of batches of transforms sent.
+                std::size_t sent{0};            ///< Number of transforms sent.
+                std::size_t skipped{0};         ///< Number of transforms not sent, as none moved.
+                std::size_t static_batches{0};  ///< Number of times static transforms were published.
+                double update_rate{0};          ///< Measured updates per second.
+                double send_rate{0};            ///< Measured transforms sent per second.
+            };
+
             /** \brief Constructor. Sets up TF2 broadcaster.
              *  \param[in] robot Robot to broadcast.
              *  \param[in] base_frame Base frame to use for robot transforms.
@@ -43,6 +76,10 @@ namespace robowflex
              */
             void stop();
 
+            /** \brief Send out the TF and joint information once. Called periodically after start().
+             */
+            void update();
+
             /** \brief Add a new static transform to the broadcaster.
              *  \param[in] name Name of transform (used for removal)
              *  \param[in] base Base frame of transform.
@@ -57,19 +94,42 @@ namespace robowflex
              */
             void removeStaticTransform(const std::string &name);
 
+            /** \brief Set the period at which all transforms are sent, changed or not. Defaults to 1 second.
+             *  \param[in] period Period in seconds. If 0, all transforms are sent every update.
+             */
+            void setKeepAlive(double period);
+
+            /** \brief Set the tolerance for a transform to be unchanged.
+             *  \param[in] tolerance Maximum change in any entry of a transform for it to be unchanged.
+             */
+            void setTolerance(double tolerance);
+
+            /** \brief Replace where transforms are sent, e.g., to check what is sent without TF. All
+             *  transforms are sent again on the next update, and static transforms are sent immediately.
+             *  \param[in] publisher Function to send batches of robot transforms to.
+             *  \param[in] static_publisher Function to send the set of static transforms to.
+             */
+            void setTransformPublishers(const TransformPublisher &publisher,
+                                        const TransformPublisher &static_publisher);
+
+            /** \brief Get statistics on published transforms.
+             *  \return The statistics.
+             */
+            Stats getStats() const;
+
         private:
-            /** \brief Send out the TF and joint information.
+            /** \brief Send out the set of static transforms. Must be called with the lock held.
              */
-            void update();
+            void publishStatic();
 
             RobotConstPtr robot_;                  ///< Robot being published.
             const std::string base_;               ///< Base frame to use.
-            bool active_{false};                   ///< Is thread active?
-            bool done_{false};                     ///< Is thread done?
+            std::atomic<bool> active_{false};      ///< Is thread active?
             unsigned int rate_{10};                ///< Times per second to send out.
             std::unique_ptr<std::thread> thread_;  ///< Worker thread.
             ros::NodeHandle nh_;                   ///< Handle for publishing.
             tf2_ros::TransformBroadcaster tf2br_;  ///< TF2 broadcaster
+            ros::Publisher static_pub_;            ///< Latched static TF publisher.
             ros::Publisher state_pub_;             ///< State publisher.
 
             /** \brief Information for a static transform.
@@ -82,6 +142,19 @@ namespace robowflex
             };
 
             std::map<std::string, StaticTransform> static_;  ///< Static transforms.
+
+            mutable std::mutex mutex_;             ///< Lock for updates, settings, and statistics.
+            TransformPublisher publisher_;         ///< Sends robot transforms.
+            TransformPublisher static_publisher_;  ///< Sends static transforms.
+            double keep_alive_{1.};                ///< Period to send all transforms.
+            double tolerance_{0.};                 ///< Tolerance for unchanged transforms.
+
+            RobotPoseVector sent_;                                ///< Last sent transform of each link.
+            RobotPoseVector transforms_;                          ///< Current transform of each link.
+            std::vector<geometry_msgs::TransformStamped> batch_;  ///< Batch of transforms being sent.
+            ros::WallTime last_all_;                              ///< Time transforms were last sent.
+            ros::WallTime first_update_;                          ///< Time of the first update.
+            Stats stats_;                                         ///< Statistics.
         };
     }  // namespace IO
 }  // namespace robowflex
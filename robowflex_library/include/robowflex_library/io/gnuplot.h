@@ -3,6 +3,13 @@
 #ifndef ROBOWFLEX_IO_GNUPLOT_
 #define ROBOWFLEX_IO_GNUPLOT_
 
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
 #include <robowflex_library/macros.h>
 #include <robowflex_library/constants.h>
 #include <robowflex_library/benchmarking.h>
@@ -26,6 +33,10 @@ namespace robowflex
 
             GNUPlotHelper() = default;
 
+            /** \brief Destructor. Finishes live plots.
+             */
+            ~GNUPlotHelper();
+
             // non-copyable
             GNUPlotHelper(GNUPlotHelper const &) = delete;
             void operator=(GNUPlotHelper const &) = delete;
@@ -42,6 +53,7 @@ namespace robowflex
                     std::string label;            ///< Axis label.
                     double max = constants::nan;  ///< Upper axis limit. If NaN, will auto-adjust.
                     double min = constants::nan;  ///< Lower axis limit. If NaN, will auto-adjust.
+                    bool log{false};              ///< If true, use a logarithmic scale.
                 };
 
                 std::string title;       ///< Title of the plot.
@@ -67,6 +79,34 @@ namespace robowflex
              */
             void timeseries(const TimeSeriesOptions &options);
 
+            /** \brief Live time series plotting options.
+             */
+            struct LiveTimeSeriesOptions : PlottingOptions
+            {
+                double rate{5.};  ///< Maximum number of replots per second.
+            };
+
+            /** \brief Start a live time series plot, replacing any live plot on the same instance.
+             *  Unlike timeseries(), which sends all points on every call, points are appended to temporary
+             *  data files that GNUPlot replots from. Points are written and GNUPlot is replotted on a
+             *  background thread, at most at the given rate, so appending points does not block.
+             *  \param[in] options Plotting options.
+             */
+            void startLiveTimeseries(const LiveTimeSeriesOptions &options);
+
+            /** \brief Append points to a series of a live time series plot.
+             *  \param[in] instance Instance of the live plot.
+             *  \param[in] name Name of the series. A new series is added to the plot if needed.
+             *  \param[in] points Points to append.
+             */
+            void appendLiveTimeseries(const std::string &instance, const std::string &name,
+                                      const Series &points);
+
+            /** \brief Stop a live time series plot. All appended points are plotted before returning.
+             *  \param[in] instance Instance of the live plot.
+             */
+            void stopLiveTimeseries(const std::string &instance);
+
             /** \brief Box plotting options.
              */
             struct BoxPlotOptions : PlottingOptions
@@ -100,6 +140,11 @@ namespace robowflex
 
                 /** \} */
 
+                /** \brief Wait until GNUPlot has run all commands written so far, e.g., so the data files
+                 *  they read can be removed. Other error output of GNUPlot read while waiting is logged.
+                 */
+                void sync();
+
             private:
                 // non-copyable
                 Instance(Instance const &) = delete;
@@ -115,12 +160,69 @@ namespace robowflex
 #endif
             };
 
+            /** \brief A live time series plot, replotted from data files on a background thread.
+             */
+            class LivePlot
+            {
+            public:
+                /** \brief Constructor. Creates a directory for data files and starts the thread.
+                 *  \param[in] instance GNUPlot instance to plot with.
+                 *  \param[in] rate Maximum number of replots per second.
+                 */
+                LivePlot(const std::shared_ptr<Instance> &instance, double rate);
+
+                /** \brief Destructor. Plots remaining points, waits for GNUPlot to read them, then removes
+                 *  the data files.
+                 */
+                ~LivePlot();
+
+                /** \brief Append points to a series.
+                 *  \param[in] name Name of the series.
+                 *  \param[in] points Points to append.
+                 */
+                void append(const std::string &name, const Series &points);
+
+            private:
+                // non-copyable
+                LivePlot(LivePlot const &) = delete;
+                void operator=(LivePlot const &) = delete;
+
+                /** \brief Write and plot appended points until destruction.
+                 */
+                void run();
+
+                /** \brief Append points to data files and replot.
+                 *  \param[in] points Points to append for each series.
+                 */
+                void plot(const std::map<std::string, Series> &points);
+
+                std::shared_ptr<Instance> instance_;  ///< GNUPlot instance.
+                const double rate_;                   ///< Maximum replots per second.
+                boost::filesystem::path directory_;   ///< Directory of data files.
+
+                std::map<std::string, std::string> files_;  ///< Map of series names to data files.
+
+                std::mutex mutex_;                       ///< Lock for appended points.
+                std::condition_variable cv_;             ///< Signals appended points.
+                std::map<std::string, Series> pending_;  ///< Points not yet written.
+                bool done_{false};                       ///< Is the plot being destroyed?
+                std::thread thread_;                     ///< Plotting thread.
+            };
+
+            /** \brief Stop a live plot if there is one on an instance.
+             *  \param[in] name Name of instance.
+             */
+            void stopLivePlot(const std::string &name);
+
             /** \brief Get the named GNUPlot instance.
              *  \param[in] name Name of instance.
              *  \return The instance.
              */
             std::shared_ptr<Instance> getInstance(const std::string &name);
             std::map<std::string, std::shared_ptr<Instance>> instances_;  ///< Map of open GNUPlot instances
+
+            std::mutex live_mutex_;                                  ///< Lock for live plots.
+            std::map<std::string, std::shared_ptr<LivePlot>> live_;  ///< Map of live plots on instances.
         };
 
         /** \brief Helper class to plot a real metric as a box plot using GNUPlot from benchmarking data.
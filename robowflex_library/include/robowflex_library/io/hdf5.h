@@ -6,6 +6,10 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <condition_variable>
 
 #include <boost/variant.hpp>
 
@@ -15,10 +19,16 @@
 
 namespace robowflex
 {
+    /** \cond IGNORE */
+    ROBOWFLEX_CLASS_FORWARD(Robot);
+    ROBOWFLEX_CLASS_FORWARD(Trajectory);
+    /** \endcond */
+
     namespace IO
     {
         /** \cond IGNORE */
         ROBOWFLEX_CLASS_FORWARD(HDF5Data)
+        ROBOWFLEX_CLASS_FORWARD(HDF5Writer)
         /** \endcond */
 
         /** \class robowflex::HDF5DataPtr
@@ -35,10 +45,11 @@ namespace robowflex
             /** \brief Constructor. Loads reads DataSet from file.
              *  \param[in] location Location to read data from.
              *  \param[in] name Name of object to read.
+             *  \param[in] lazy If true, the data is not read until it is first accessed.
              *  \tparam H5 type to read.
              */
             template <typename T>
-            HDF5Data(const T &location, const std::string &name);
+            HDF5Data(const T &location, const std::string &name, bool lazy = false);
 
             /** \brief Destructor. Cleans up all read data.
              */
@@ -51,10 +62,27 @@ namespace robowflex
             const std::vector<hsize_t> getDims() const;
 
             /** \brief Get a pointer to the underlying data array. It is of size type[dim0][dim1]...
+             *  If the data was opened lazily, the whole dataset is read on first access.
              *  \return A pointer to the data array.
              */
             const void *getData() const;
 
+            /** \brief Checks if the whole dataset has been read into memory.
+             *  \return True if the data is in memory.
+             */
+            bool isLoaded() const;
+
+            /** \brief Read a hyperslab (a block of indices) of the dataset into a caller-provided buffer,
+             *  without reading the rest of the dataset.
+             *  \param[in] offset The starting index at each dimension.
+             *  \param[in] count The number of elements to read at each dimension.
+             *  \param[out] buffer Buffer to read into. Must hold the product of \a count elements of the
+             *  data's type, int for integer data and double for floating point data.
+             *  \return True on success, false on failure.
+             */
+            bool read(const std::vector<hsize_t> &offset, const std::vector<hsize_t> &count,
+                      void *buffer) const;
+
             /** \brief Get a string describing the data.
              *  \return A string describing the data.
              */
@@ -74,6 +102,11 @@ namespace robowflex
              */
             std::tuple<H5::PredType, unsigned int, std::string> getDataProperties() const;
 
+            /** \brief Read the whole dataset into memory, if it is not already.
+             *  \return A pointer to the data array.
+             */
+            const void *load() const;
+
             const H5::DataSet dataset_;  ///< Dataset being read from.
             const H5::DataSpace space_;  ///< Size of the dataset.
 
@@ -81,7 +114,8 @@ namespace robowflex
             const int rank_;          ///< Rank of the dataset.
             const hsize_t *dims_;     ///< Dimensions of the dataset (rank_ dimensions)
 
-            const void *data_;  ///< Data itself.
+            mutable const void *data_{nullptr};  ///< Data itself, null until read.
+            mutable std::mutex mutex_;           ///< Mutex for reading data.
         };
 
         /** \brief An HDF5 File loaded into memory.
@@ -97,10 +131,30 @@ namespace robowflex
              */
             typedef std::map<std::string, Node> NodeMap;
 
+            /** \brief Options for the raw data chunk cache of each dataset. Reads of chunked datasets are
+             *  much faster if the chunks being accessed fit in the cache. See H5Pset_cache().
+             */
+            struct CacheOptions
+            {
+                std::size_t slots{521};          ///< Number of chunk slots, ideally a prime number.
+                std::size_t bytes{1024 * 1024};  ///< Total size of the cache in bytes.
+                double w0{0.75};                 ///< Preemption policy, from 0 to 1.
+            };
+
             /** \brief Constructor. Opens \a filename.
              *  \param[in] filename File to open.
+             *  \param[in] lazy If true, only the hierarchy of the file is indexed, and datasets are read
+             *  when first accessed. Otherwise, all datasets are read.
              */
-            HDF5File(const std::string &filename);
+            HDF5File(const std::string &filename, bool lazy = false);
+
+            /** \brief Constructor. Opens \a filename with a tuned chunk cache.
+             *  \param[in] filename File to open.
+             *  \param[in] lazy If true, only the hierarchy of the file is indexed, and datasets are read
+             *  when first accessed. Otherwise, all datasets are read.
+             *  \param[in] cache Chunk cache options.
+             */
+            HDF5File(const std::string &filename, bool lazy, const CacheOptions &cache);
 
             /** \brief Get the dataset under the set of keys. Each key is applied successively.
              *  \param[in] keys The keys for the dataset to access.
@@ -113,6 +167,19 @@ namespace robowflex
              */
             const std::vector<std::vector<std::string>> getKeys() const;
 
+            /** \brief Gets the names of all trajectories written by an HDF5Writer.
+             *  \return The names of the trajectories.
+             */
+            std::vector<std::string> getTrajectoryNames() const;
+
+            /** \brief Load a trajectory written by an HDF5Writer.
+             *  \param[in] name Name of the trajectory.
+             *  \param[in] robot Robot to create the trajectory for. Joints not in the trajectory are set from
+             *  the robot's scratch state.
+             *  \return The trajectory, or null on failure.
+             */
+            TrajectoryPtr getTrajectory(const std::string &name, const RobotConstPtr &robot) const;
+
         private:
             /** \brief List the objects at the HDF5 location.
              *  \param[in] location The location to search
@@ -130,9 +197,138 @@ namespace robowflex
             template <typename T>
             void loadData(Node &node, const T &location, const std::string &name);
 
+            const bool lazy_;        ///< If true, datasets are read on first access.
             const H5::H5File file_;  ///< The loaded HDF5 file.
             Node data_;              ///< A recursive map of loaded data.
         };
+
+        /** \class robowflex::IO::HDF5WriterPtr
+            \brief A shared pointer wrapper for robowflex::IO::HDF5Writer. */
+
+        /** \class robowflex::IO::HDF5WriterConstPtr
+            \brief A const shared pointer wrapper for robowflex::IO::HDF5Writer. */
+
+        /** \brief Writes trajectories and batches of states to an HDF5 file as chunked, compressed datasets.
+         *  Trajectories are written to `/trajectories/<name>`, with `positions` and `velocities` datasets of
+         *  size waypoints x joints, a `time` dataset of time from start, and `group` and `joint_names`
+         *  attributes. Batches of states are appended to the `positions` dataset of `/states/<name>`. Only
+         *  single-DOF joints are written. All methods are thread-safe; data is converted on the calling
+         *  thread, and written by a single background writer thread. Read trajectories back with
+         *  HDF5File::getTrajectory().
+         */
+        class HDF5Writer
+        {
+        public:
+            /** \brief Options for writing.
+             */
+            struct Options
+            {
+                hsize_t chunk_rows{256};  ///< Number of rows in each chunk of a dataset.
+                int compression{6};       ///< Deflate compression level from 0 to 9. No compression if 0.
+            };
+
+            /** \brief Constructor. Creates \a filename, overwriting it if it exists, with default options.
+             *  \param[in] filename File to write.
+             */
+            HDF5Writer(const std::string &filename);
+
+            /** \brief Constructor. Creates \a filename, overwriting it if it exists.
+             *  \param[in] filename File to write.
+             *  \param[in] options Options for writing.
+             */
+            HDF5Writer(const std::string &filename, const Options &options);
+
+            /** \brief Destructor. Writes all queued data and closes the file.
+             */
+            ~HDF5Writer();
+
+            // non-copyable
+            HDF5Writer(const HDF5Writer &) = delete;
+            HDF5Writer &operator=(const HDF5Writer &) = delete;
+
+            /** \brief Queue a trajectory to be written. Trajectories without joints, or with a waypoint that
+             *  does not have a position for each joint, are not written.
+             *  \param[in] name Name of the trajectory. Must be unique in the file.
+             *  \param[in] trajectory Trajectory to write.
+             */
+            void addTrajectory(const std::string &name, const Trajectory &trajectory);
+
+            /** \brief Queue a batch of states to be appended to a dataset. The batch is not written if any
+             *  state does not have a value for each joint.
+             *  \param[in] name Name of the dataset.
+             *  \param[in] joint_names Names of the joints in each state. Must not be empty, and must be the
+             *  same for all batches appended to a dataset.
+             *  \param[in] states States to append, each with a value for each joint.
+             */
+            void addStates(const std::string &name, const std::vector<std::string> &joint_names,
+                           const std::vector<std::vector<double>> &states);
+
+            /** \brief Wait until all queued data is written and flushed to disk.
+             */
+            void flush();
+
+        private:
+            /** \brief Data queued to be written.
+             */
+            struct Job
+            {
+                enum Type
+                {
+                    TRAJECTORY,
+                    STATES,
+                    FLUSH
+                };
+
+                Type type;                             ///< Type of job.
+                std::string name;                      ///< Name of the trajectory or dataset.
+                std::string group;                     ///< Planning group of the trajectory.
+                std::vector<std::string> joint_names;  ///< Names of joints.
+                hsize_t rows{0};                       ///< Number of waypoints or states.
+                std::vector<double> positions;         ///< Positions, rows x joints.
+                std::vector<double> velocities;        ///< Velocities, rows x joints. May be empty.
+                std::vector<double> times;             ///< Time from start of each waypoint.
+            };
+
+            /** \brief Queue a job for the writer thread.
+             *  \param[in] job Job to queue.
+             */
+            void submit(Job &&job);
+
+            /** \brief Writer thread process.
+             */
+            void run();
+
+            /** \brief Write a trajectory.
+             *  \param[in] job Trajectory to write.
+             */
+            void writeTrajectory(const Job &job);
+
+            /** \brief Append a batch of states.
+             *  \param[in] job States to write.
+             */
+            void writeStates(const Job &job);
+
+            /** \brief Create and write a chunked, compressed dataset.
+             *  \param[in] group Group to create the dataset in.
+             *  \param[in] name Name of the dataset.
+             *  \param[in] data Data to write, rows x cols.
+             *  \param[in] rows Number of rows.
+             *  \param[in] cols Number of columns. If 0, the dataset has rank 1.
+             */
+            void writeDataset(const H5::Group &group, const std::string &name,
+                              const std::vector<double> &data, hsize_t rows, hsize_t cols);
+
+            const Options options_;  ///< Options for writing.
+            H5::H5File file_;        ///< The file being written.
+
+            std::queue<Job> queue_;         ///< Queued jobs.
+            std::size_t pending_{0};        ///< Number of queued or running jobs.
+            bool active_{true};             ///< Is the writer thread active?
+            std::mutex mutex_;              ///< Job queue mutex.
+            std::condition_variable cv_;    ///< Job queue condition variable.
+            std::condition_variable done_;  ///< Condition variable for completed jobs.
+            std::thread thread_;            ///< Writer thread.
+        };
     }  // namespace IO
 }  // namespace robowflex
 
@@ -3,6 +3,13 @@
 #ifndef ROBOWFLEX_IO_VISUALIZATION_
 #define ROBOWFLEX_IO_VISUALIZATION_
 
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <moveit_msgs/DisplayTrajectory.h>
 #include <moveit/planning_interface/planning_interface.h>
 
 #include <robowflex_library/class_forward.h>
@@ -46,9 +53,34 @@ namespace robowflex
              */
             RVIZHelper(const RobotConstPtr &robot, const std::string &name = "robowflex");
 
+            /** \brief Destructor. A trajectory update that has not been published yet is published first,
+             *  waiting up to TrajectoryOptions::flush_timeout for subscribers, and discarded otherwise.
+             */
+            ~RVIZHelper();
+
             /** \name Trajectories
+             *  Trajectory updates are published on a background thread, so they do not block the caller
+             *  waiting for subscribers. If updates are made faster than they are published, only the latest
+             *  update is published.
              *  \{ */
 
+            /** \brief Options for publishing trajectory updates.
+             */
+            struct TrajectoryOptions
+            {
+                double rate{10.};                 ///< Maximum trajectory updates published per second.
+                std::size_t max_trajectories{0};  ///< Maximum trajectories per update. 0 for no limit.
+                std::size_t max_waypoints{0};     ///< Maximum waypoints per trajectory. 0 for no limit.
+                double flush_timeout{1.};         ///< Seconds to wait on destruction to publish the last
+                                                  ///< update.
+            };
+
+            /** \brief Set options for publishing trajectory updates. Trajectories and waypoints over the
+             *  limits are dropped evenly, keeping the first and last.
+             *  \param[in] options Options to use.
+             */
+            void setTrajectoryOptions(const TrajectoryOptions &options);
+
             /** \brief Updates the trajectory being visualized.
              *  \param[in] response Planning response to visualize.
              */
@@ -245,6 +277,22 @@ namespace robowflex
                             const RobotPose &pose, const Eigen::Vector4d &color,
                             const Eigen::Vector3d &scale) const;
 
+            /** \brief Convert a trajectory to a message, keeping at most the maximum number of waypoints.
+             *  \param[in] trajectory Trajectory to convert.
+             *  \param[out] msg Converted trajectory.
+             */
+            void toTrajectoryMsg(const robot_trajectory::RobotTrajectoryPtr &trajectory,
+                                 moveit_msgs::RobotTrajectory &msg) const;
+
+            /** \brief Queue a trajectory update to be published, replacing any update not yet published.
+             *  \param[in] out Trajectory update to publish.
+             */
+            void queueTrajectory(moveit_msgs::DisplayTrajectory &&out);
+
+            /** \brief Publish queued trajectory updates until destruction.
+             */
+            void publishTrajectories();
+
             RobotConstPtr robot_;            ///< Robot being visualized.
             ros::NodeHandle nh_;             ///< Handle for publishing.
             ros::Publisher marker_pub_;      ///< Marker publisher.
@@ -254,6 +302,14 @@ namespace robowflex
             ros::Publisher state_pub_;       ///< State publisher.
 
             std::multimap<std::string, visualization_msgs::Marker> markers_;  ///< Markers to publish.
+
+            TrajectoryOptions trajectory_options_;                      ///< Trajectory update options.
+            mutable std::mutex trajectory_mutex_;                       ///< Lock for trajectory updates.
+            std::condition_variable trajectory_cv_;                     ///< Signals queued updates.
+            std::unique_ptr<moveit_msgs::DisplayTrajectory> pending_;  ///< Update not yet published.
+            bool done_{false};                                          ///< Is the helper being destroyed?
+            std::chrono::steady_clock::time_point flush_deadline_;      ///< Time to give up publishing by.
+            std::thread trajectory_thread_;                             ///< Trajectory publishing thread.
         };
     }  // namespace IO
 
@@ -1,23 +1,32 @@
 #ifndef ROBOWFLEX_OPENRAVE_
 #define ROBOWFLEX_OPENRAVE_
 
+#include <thread>
+
 #include <moveit_msgs/PlanningScene.h>
 
 namespace robowflex
 {
     namespace openrave
     {
-        /** \brief Loads a planning_scene from an OpenRAVE Environment XML
+        /** \brief Loads a planning_scene from an OpenRAVE Environment XML.
+         *  The XML is first scanned for collision objects, and then all referenced meshes are loaded in
+         *  parallel. If a cache directory is given, the converted collision objects are cached, keyed by the
+         *  contents of the XML and all files it references.
          *  \param[out] planning_scene The output MoveIt message that will be filled with the planning scene
          *  contents.
          *  \param[in] file The path to the OpenRAVE environment XML.
          *  \param[in] model_dir The path to the models directory, which should contain files referenced by
          * the passed in file. In OpenRAVE, "the root directory for all models files is the folder openrave is
          * launched at."
+         *  \param[in] threads Number of threads to load meshes with.
+         *  \param[in] cache_directory Directory to cache converted environments in. Not cached if empty.
          *  \return True on success, false on failure.
          */
         bool fromXMLFile(moveit_msgs::PlanningScene &planning_scene, const std::string &file,
-                         const std::string &model_dir);
+                         const std::string &model_dir,
+                         unsigned int threads = std::thread::hardware_concurrency(),
+                         const std::string &cache_directory = "");
     }  // namespace openrave
 }  // namespace robowflex
 
@@ -0,0 +1,83 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_PERF_
+#define ROBOWFLEX_PERF_
+
+#include <array>    // for std::array
+#include <cstdint>  // for uint64_t
+
+namespace robowflex
+{
+    /** \brief Hardware and software performance counters for the calling thread.
+     *  Counters are collected using Linux `perf_event_open()`. Counters are inherited by threads spawned
+     *  after start(), so multi-threaded planners are accounted for as long as their threads are joined
+     *  before stop(). If a counter cannot be opened (e.g., no PMU access in a container or a restrictive
+     *  `perf_event_paranoid` setting), it is marked unavailable and reads as zero.
+     *  CPU time is taken from `getrusage()` for the whole process, so it includes planner worker threads
+     *  regardless of when they were spawned, but also any other thread that runs between start() and stop().
+     */
+    class PerfCounters
+    {
+    public:
+        /** \brief Counters that are collected.
+         */
+        enum Counter
+        {
+            CYCLES = 0,        ///< CPU cycles.
+            INSTRUCTIONS,      ///< Retired instructions.
+            CACHE_MISSES,      ///< Last-level cache misses.
+            BRANCH_MISSES,     ///< Mispredicted branches.
+            CONTEXT_SWITCHES,  ///< Context switches.
+            NUM_COUNTERS       ///< Number of counters.
+        };
+
+        /** \brief Values measured between a start() and stop().
+         */
+        struct Sample
+        {
+            std::array<uint64_t, NUM_COUNTERS> values{};  ///< Counter values, indexed by Counter.
+            std::array<bool, NUM_COUNTERS> available{};   ///< Was each counter available?
+            double user_time{0.};                         ///< User CPU time of the process in seconds.
+            double system_time{0.};                       ///< System CPU time of the process in seconds.
+
+            /** \brief Returns true if any hardware or software counter was available.
+             *  \return True if at least one counter was collected.
+             */
+            bool anyAvailable() const;
+        };
+
+        /** \brief Constructor. Opens all counters for the calling thread in a disabled state.
+         */
+        PerfCounters();
+
+        /** \brief Destructor. Closes all counters.
+         */
+        ~PerfCounters();
+
+        // non-copyable
+        PerfCounters(PerfCounters const &) = delete;
+        void operator=(PerfCounters const &) = delete;
+
+        /** \brief Reset and enable all counters, and record initial CPU time.
+         */
+        void start();
+
+        /** \brief Disable all counters and read their values.
+         *  \return The values measured since start().
+         */
+        Sample stop();
+
+        /** \brief Get a name for a counter, suitable for use as a metric name.
+         *  \param[in] counter Counter to get name of.
+         *  \return The name of the counter.
+         */
+        static const char *getName(Counter counter);
+
+    private:
+        std::array<int, NUM_COUNTERS> fds_;  ///< File descriptors for each counter, -1 if unavailable.
+        double user_start_{0.};              ///< User CPU time at start().
+        double system_start_{0.};            ///< System CPU time at start().
+    };
+}  // namespace robowflex
+
+#endif
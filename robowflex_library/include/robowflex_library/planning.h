@@ -167,6 +167,88 @@ namespace robowflex
         std::condition_variable cv_;       ///< Planner condition variable
     };
 
+    /** \cond IGNORE */
+    ROBOWFLEX_CLASS_FORWARD(DeadlinePlanner);
+    /** \endcond */
+
+    /** \class robowflex::DeadlinePlannerPtr
+        \brief A shared pointer wrapper for robowflex::DeadlinePlanner. */
+
+    /** \class robowflex::DeadlinePlannerConstPtr
+        \brief A const shared pointer wrapper for robowflex::DeadlinePlanner. */
+
+    /** \brief A wrapper around any robowflex::Planner that enforces a hard wall-clock deadline.
+     *  Planners often overshoot the allowed planning time of a request due to planning adapters, path
+     *  simplification, and time parameterization after the core solve. This planner gives the wrapped planner
+     *  a reduced time budget (so it can return its best result in time), and runs it on a background thread.
+     *  If the wrapped planner has not returned by the deadline, a response with the error code
+     *  moveit_msgs::MoveItErrorCodes::TIMED_OUT is returned immediately and the late result is discarded.
+     *  Calls are serialized, so a call made while a late result is still being computed waits for it as part
+     *  of its own deadline. Calls to preRun() and getProgressProperties() also wait for any late result, but
+     *  only up to the deadline. If it is still running, preRun() of the wrapped planner is skipped and no
+     *  progress properties are returned.
+     */
+    class DeadlinePlanner : public Planner
+    {
+    public:
+        /** \brief Constructor.
+         *  \param[in] planner The planner to wrap.
+         *  \param[in] name Optional namespace for planner.
+         */
+        DeadlinePlanner(const PlannerPtr &planner, const std::string &name = "");
+
+        // non-copyable
+        DeadlinePlanner(DeadlinePlanner const &) = delete;
+        void operator=(DeadlinePlanner const &) = delete;
+
+        /** \brief Set the hard deadline used for each call to plan().
+         *  \param[in] deadline Deadline in seconds. If non-positive, the allowed planning time of the request
+         *  is used as the deadline.
+         */
+        void setDeadline(double deadline);
+
+        /** \brief Set the fraction of the deadline reserved for post-processing by the wrapped planner.
+         *  The wrapped planner is given an allowed planning time of `(1 - margin) * deadline`.
+         *  \param[in] margin Fraction of deadline in [0, 1).
+         */
+        void setMargin(double margin);
+
+        /** \brief Get the wrapped planner.
+         *  \return The wrapped planner.
+         */
+        const PlannerPtr &getPlanner() const;
+
+        /** \brief Plan a motion given a \a request and a \a scene, returning by the deadline.
+         *  \param[in] scene A planning scene for the same \a robot_ to compute the plan in.
+         *  \param[in] request The motion planning request to solve.
+         *  \return The motion planning response generated by the wrapped planner, or a response with the
+         *  error code TIMED_OUT if the deadline was exceeded.
+         */
+        planning_interface::MotionPlanResponse
+        plan(const SceneConstPtr &scene, const planning_interface::MotionPlanRequest &request) override;
+
+        std::vector<std::string> getPlannerConfigs() const override;
+
+        std::map<std::string, ProgressProperty>
+        getProgressProperties(const SceneConstPtr &scene,
+                              const planning_interface::MotionPlanRequest &request) const override;
+
+        void preRun(const SceneConstPtr &scene,
+                    const planning_interface::MotionPlanRequest &request) override;
+
+    private:
+        /** \brief Get the deadline for a request.
+         *  \param[in] request The motion planning request.
+         *  \return The deadline in seconds.
+         */
+        double getDeadline(const planning_interface::MotionPlanRequest &request) const;
+
+        PlannerPtr planner_;   ///< Wrapped planner.
+        double deadline_{0.};  ///< Hard deadline. If non-positive, uses request time.
+        double margin_{0.1};   ///< Fraction of deadline reserved for post-processing.
+        Pool pool_{1};         ///< Single thread that runs the wrapped planner.
+    };
+
     /** \cond IGNORE */
     ROBOWFLEX_CLASS_FORWARD(SimpleCartesianPlanner);
     /** \endcond */
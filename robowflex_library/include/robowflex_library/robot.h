@@ -742,6 +742,22 @@ namespace robowflex
         bool dumpPathTransforms(const robot_trajectory::RobotTrajectory &path, const std::string &filename,
                                 double fps = 30, double threshold = 0.0) const;
 
+        /** \brief Dumps the tranforms of all links of a robot through a robot trajectory to a compact binary
+         *  file, written one frame at a time with robowflex::IO::AnimationWriter. Memory use is constant in
+         *  the length of the path. The file can be read with robowflex::IO::AnimationReader, and converted
+         *  to the YAML format of dumpPathTransforms() with IO::AnimationReader::toYAMLFile().
+         *  \param[in] path Path to output.
+         *  \param[in] filename Filename to output to.
+         *  \param[in] fps The transforms (frames) per second used to interpolate the given path.
+         *  \param[in] threshold The minimum distance between states before transforms are output.
+         *  \param[in] keyframe_interval Number of frames from one keyframe to the next. Frames in between
+         *  only store links that moved. If 0, all frames are keyframes.
+         *  \return True on success, false on failure.
+         */
+        bool dumpPathAnimation(const robot_trajectory::RobotTrajectory &path, const std::string &filename,
+                               double fps = 30, double threshold = 0.0,
+                               std::size_t keyframe_interval = 0) const;
+
         /** \brief Dumps the current scratch configuration of the robot to a YAML file compatible with a
          * scene.
          *  \param[in] filename Filename to output to.
@@ -23,6 +23,7 @@ namespace robowflex
     /** \cond IGNORE */
     ROBOWFLEX_CLASS_FORWARD(Robot);
     ROBOWFLEX_CLASS_FORWARD(Geometry);
+    ROBOWFLEX_CLASS_FORWARD(MeshSimplifier);
     /** \endcond */
 
     /** \cond IGNORE */
@@ -116,6 +117,17 @@ namespace robowflex
          */
         void useMessage(const moveit_msgs::PlanningScene &msg, bool diff = false);
 
+        /** \brief Set a mesh simplifier to simplify meshes as they are added to the scene through
+         *  updateCollisionObject(), fromYAMLFile(), and fromOpenRAVEXMLFile().
+         *  \param[in] simplifier Simplifier to use. If null, meshes are added as is.
+         */
+        void setMeshSimplifier(const MeshSimplifierPtr &simplifier);
+
+        /** \brief Get the mesh simplifier used by the scene.
+         *  \return The mesh simplifier, or null if meshes are not simplified.
+         */
+        const MeshSimplifierPtr &getMeshSimplifier() const;
+
         /** \} */
 
         /** \name Collision Object Management
@@ -333,7 +345,15 @@ namespace robowflex
          *  \return True on success, false on failure.
          */
         bool fromYAMLFile(const std::string &file);
-        bool fromOpenRAVEXMLFile(const std::string &file, std::string models_dir = "");
+
+        /** \brief Load a planning scene from an OpenRAVE environment XML file. See openrave::fromXMLFile().
+         *  \param[in] file File to load planning scene from.
+         *  \param[in] models_dir Directory of models referenced by the file. If empty, the file's directory.
+         *  \param[in] cache_directory Directory to cache converted environments in. Not cached if empty.
+         *  \return True on success, false on failure.
+         */
+        bool fromOpenRAVEXMLFile(const std::string &file, std::string models_dir = "",
+                                 const std::string &cache_directory = "");
 
         /** \} */
 
@@ -349,6 +369,7 @@ namespace robowflex
 
         CollisionPluginLoaderPtr loader_;  ///< Plugin loader that sets collision detectors for the scene.
         planning_scene::PlanningScenePtr scene_;  ///< Underlying planning scene.
+        MeshSimplifierPtr simplifier_;            ///< Simplifier for meshes added to the scene.
     };
 }  // namespace robowflex
 
@@ -0,0 +1,158 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_SIMPLIFY_
+#define ROBOWFLEX_SIMPLIFY_
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <geometric_shapes/shapes.h>
+
+#include <moveit_msgs/PlanningScene.h>
+
+#include <robowflex_library/adapter.h>
+#include <robowflex_library/class_forward.h>
+
+namespace robowflex
+{
+    /** \cond IGNORE */
+    ROBOWFLEX_CLASS_FORWARD(MeshSimplifier);
+    /** \endcond */
+
+    /** \class robowflex::MeshSimplifierPtr
+        \brief A shared pointer wrapper for robowflex::MeshSimplifier. */
+
+    /** \class robowflex::MeshSimplifierConstPtr
+        \brief A const shared pointer wrapper for robowflex::MeshSimplifier. */
+
+    /** \brief Simplifies mesh obstacles into cheaper collision geometry.
+     *  High resolution meshes (e.g., from scans) dominate collision checking time. A simplifier can be set on
+     *  a Scene with Scene::setMeshSimplifier(), after which meshes are simplified as they are added to the
+     *  scene through Scene::updateCollisionObject(), Scene::fromYAMLFile(), and Scene::fromOpenRAVEXMLFile().
+     *  Simplified meshes can be cached on disk, keyed by the contents of the mesh and the options used.
+     */
+    class MeshSimplifier
+    {
+    public:
+        /** \brief Method of simplification.
+         */
+        enum Method
+        {
+            DECIMATE = 0,     ///< Vertex clustering, with a bounded surface distance from the original mesh.
+            CONVEX_HULL = 1,  ///< Convex hull of the mesh.
+            BOX = 2           ///< Axis-aligned bounding box of the mesh, as a box primitive.
+        };
+
+        /** \brief Options for simplification.
+         */
+        struct Options
+        {
+            Method method{DECIMATE};          ///< Method of simplification.
+            double max_error{0.01};           ///< For DECIMATE, the maximum distance any vertex is moved,
+                                              ///< which bounds the Hausdorff distance to the original.
+            std::size_t min_triangles{1000};  ///< Meshes with fewer triangles are not simplified.
+            std::string cache_directory;      ///< Directory to cache simplified meshes in. Not cached if
+                                              ///< empty.
+        };
+
+        /** \brief A simplified mesh.
+         */
+        struct Result
+        {
+            bool simplified{false};                   ///< True if the mesh was simplified.
+            shapes::ShapeConstPtr shape;              ///< Simplified shape, a mesh or a box.
+            RobotPose offset{RobotPose::Identity()};  ///< Pose of the simplified shape in the mesh's frame.
+            std::size_t triangles{0};                 ///< Number of triangles in the original mesh.
+            std::size_t simplified_triangles{0};      ///< Number of triangles in the simplified shape.
+            double error{std::numeric_limits<double>::quiet_NaN()};  ///< Bound on distance from the original
+                                                                     ///< surface. Only known for DECIMATE.
+        };
+
+        /** \brief Constructor. Uses the default options.
+         */
+        MeshSimplifier();
+
+        /** \brief Constructor.
+         *  \param[in] options Simplification options.
+         */
+        MeshSimplifier(const Options &options);
+
+        /** \brief Get the options for simplification.
+         *  \return A reference to the options.
+         */
+        Options &getOptions();
+
+        /** \brief Simplify a shape. Results are remembered for each shape, so simplifying the same shape
+         *  again (e.g., when moving an object) returns the same simplified shape.
+         *  \param[in] shape Shape to simplify. Shapes that are not meshes are returned as is.
+         *  \return The simplified shape.
+         */
+        Result simplify(const shapes::ShapeConstPtr &shape);
+
+        /** \brief Simplify all mesh collision objects in a planning scene message. Meshes simplified to a box
+         *  are replaced with a box primitive.
+         *  \param[in,out] msg Message to simplify.
+         *  \return The number of meshes simplified.
+         */
+        std::size_t simplify(moveit_msgs::PlanningScene &msg);
+
+        /** \brief Simplify a mesh, without remembering the result.
+         *  \param[in] mesh Mesh to simplify.
+         *  \return The simplified mesh.
+         */
+        Result compute(const shapes::Mesh &mesh) const;
+
+    private:
+        /** \brief Simplify a mesh by vertex clustering.
+         *  \param[in] mesh Mesh to simplify.
+         *  \return The simplified mesh.
+         */
+        Result decimate(const shapes::Mesh &mesh) const;
+
+        /** \brief Simplify a mesh into its convex hull.
+         *  \param[in] mesh Mesh to simplify.
+         *  \return The simplified mesh.
+         */
+        Result convexHull(const shapes::Mesh &mesh) const;
+
+        /** \brief Simplify a mesh into its bounding box.
+         *  \param[in] mesh Mesh to simplify.
+         *  \return The simplified mesh.
+         */
+        Result boundingBox(const shapes::Mesh &mesh) const;
+
+        /** \brief Get the file a simplified mesh is cached in.
+         *  \param[in] mesh Mesh to get cache file for.
+         *  \return The cache file.
+         */
+        std::string getCacheFile(const shapes::Mesh &mesh) const;
+
+        /** \brief Load a simplified mesh from the disk cache.
+         *  \param[in] file Cache file to load.
+         *  \param[out] result The loaded simplified mesh.
+         *  \return True on success, false on failure.
+         */
+        static bool loadCacheFile(const std::string &file, Result &result);
+
+        /** \brief Save a simplified mesh to the disk cache.
+         *  \param[in] file Cache file to save to.
+         *  \param[in] result The simplified mesh.
+         *  \return True on success, false on failure.
+         */
+        static bool saveCacheFile(const std::string &file, const Result &result);
+
+        /** \brief A remembered simplification of a shape. If the shape was not simplified, the result has no
+         *  shape, so the memo does not keep the original shape alive.
+         */
+        using Memo = std::pair<std::weak_ptr<const shapes::Shape>, Result>;
+
+        Options options_;                              ///< Simplification options.
+        std::map<const shapes::Shape *, Memo> memos_;  ///< Remembered simplifications of shapes.
+        std::mutex mutex_;                             ///< Mutex for remembered simplifications.
+    };
+}  // namespace robowflex
+
+#endif
@@ -0,0 +1,207 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_STATISTICS_
+#define ROBOWFLEX_STATISTICS_
+
+#include <array>    // for std::array
+#include <cstddef>  // for std::size_t
+#include <vector>   // for std::vector
+
+namespace robowflex
+{
+    /** \brief Collection of methods for summarizing and comparing samples of data.
+     */
+    namespace stats
+    {
+        /** \brief Compute the mean of a set of values.
+         *  \param[in] values Values to compute mean of.
+         *  \return The mean, or NaN if \a values is empty.
+         */
+        double mean(const std::vector<double> &values);
+
+        /** \brief Compute the unbiased sample variance of a set of values.
+         *  \param[in] values Values to compute variance of.
+         *  \return The variance, or 0 if there are fewer than two values.
+         */
+        double variance(const std::vector<double> &values);
+
+        /** \brief Compute a quantile of a set of values, linearly interpolating between closest ranks.
+         *  \param[in] values Values to compute quantile of. Does not need to be sorted.
+         *  \param[in] q Quantile to compute, in [0, 1].
+         *  \return The quantile, or NaN if \a values is empty.
+         */
+        double quantile(std::vector<double> values, double q);
+
+        /** \brief Compute a quantile of an already sorted set of values.
+         *  \param[in] sorted Sorted values to compute quantile of.
+         *  \param[in] q Quantile to compute, in [0, 1].
+         *  \return The quantile, or NaN if \a sorted is empty.
+         */
+        double quantileSorted(const std::vector<double> &sorted, double q);
+
+        /** \brief Summary statistics of a set of values.
+         */
+        struct Summary
+        {
+            std::size_t n{0};  ///< Number of values.
+            double mean;       ///< Mean.
+            double stddev;     ///< Sample standard deviation.
+            double min;        ///< Minimum value.
+            double q25;        ///< First quartile.
+            double median;     ///< Median.
+            double q75;        ///< Third quartile.
+            double q95;        ///< 95th percentile.
+            double max;        ///< Maximum value.
+        };
+
+        /** \brief Compute summary statistics of a set of values.
+         *  \param[in] values Values to summarize.
+         *  \return The summary. If \a values is empty, all statistics are NaN.
+         */
+        Summary summarize(const std::vector<double> &values);
+
+        /** \brief A fitted power law, `y = coefficient * x^exponent`.
+         */
+        struct PowerLaw
+        {
+            double coefficient;  ///< Multiplicative coefficient.
+            double exponent;     ///< Scaling exponent.
+            double r2;           ///< Coefficient of determination of the fit in log-log space.
+        };
+
+        /** \brief Fit a power law to a set of points by least squares in log-log space.
+         *  Points where either coordinate is non-positive or non-finite are ignored.
+         *  \param[in] x Independent values.
+         *  \param[in] y Dependent values, must be the same size as \a x.
+         *  \return The fitted power law. If fewer than two points are usable, all fields are NaN.
+         */
+        PowerLaw fitPowerLaw(const std::vector<double> &x, const std::vector<double> &y);
+
+        /** \brief Result of a two-sample hypothesis test.
+         */
+        struct TestResult
+        {
+            double statistic;  ///< Test statistic.
+            double z;          ///< Standard normal score of the statistic.
+            double p;          ///< Two-sided p-value.
+            double effect;     ///< Effect size. Positive if the first sample tends to be larger.
+        };
+
+        /** \brief Compute the cumulative distribution function of the standard normal distribution.
+         *  \param[in] z Value to evaluate at.
+         *  \return Probability that a standard normal variable is less than \a z.
+         */
+        double normalCDF(double z);
+
+        /** \brief Mann-Whitney U test (Wilcoxon rank-sum test) of whether two samples come from the same
+         *  distribution. Uses the normal approximation with tie and continuity correction.
+         *  \param[in] a First sample.
+         *  \param[in] b Second sample.
+         *  \return The test result. \a statistic is U for \a a, and \a effect is the rank-biserial
+         *  correlation in [-1, 1]. If either sample is empty, \a p is 1 and all other fields are 0.
+         */
+        TestResult mannWhitneyU(const std::vector<double> &a, const std::vector<double> &b);
+
+        /** \brief Pooled two-proportion z-test of whether two success rates are equal.
+         *  \param[in] successes_a Successes in the first sample.
+         *  \param[in] n_a Size of the first sample.
+         *  \param[in] successes_b Successes in the second sample.
+         *  \param[in] n_b Size of the second sample.
+         *  \return The test result. \a statistic is the difference in proportions, and \a effect is
+         *  Cohen's h. If either sample is empty, \a p is 1 and all other fields are 0.
+         */
+        TestResult proportionTest(std::size_t successes_a, std::size_t n_a,  //
+                                  std::size_t successes_b, std::size_t n_b);
+
+        /** \brief Streaming mean, variance, and range of a sequence of values in constant memory, using
+         *  Welford's algorithm.
+         */
+        class Moments
+        {
+        public:
+            /** \brief Add a value.
+             *  \param[in] value Value to add.
+             */
+            void add(double value);
+
+            /** \brief Get the number of values added.
+             *  \return The number of values.
+             */
+            std::size_t getCount() const;
+
+            /** \brief Get the mean of values added.
+             *  \return The mean, or NaN if no values have been added.
+             */
+            double getMean() const;
+
+            /** \brief Get the unbiased sample variance of values added.
+             *  \return The variance, or 0 if fewer than two values have been added.
+             */
+            double getVariance() const;
+
+            /** \brief Get the sample standard deviation of values added.
+             *  \return The standard deviation, or 0 if fewer than two values have been added.
+             */
+            double getStandardDeviation() const;
+
+            /** \brief Get the minimum value added.
+             *  \return The minimum, or NaN if no values have been added.
+             */
+            double getMin() const;
+
+            /** \brief Get the maximum value added.
+             *  \return The maximum, or NaN if no values have been added.
+             */
+            double getMax() const;
+
+        private:
+            std::size_t n_{0};  ///< Number of values.
+            double mean_{0.};   ///< Running mean.
+            double m2_{0.};     ///< Running sum of squared differences from the mean.
+            double min_{0.};    ///< Minimum value.
+            double max_{0.};    ///< Maximum value.
+        };
+
+        /** \brief Streaming estimate of a quantile in constant memory, using the P-squared algorithm of Jain
+         *  and Chlamtac. The estimate is exact for fewer than five values.
+         */
+        class P2Quantile
+        {
+        public:
+            /** \brief Constructor.
+             *  \param[in] q Quantile to estimate, in [0, 1].
+             */
+            P2Quantile(double q = 0.5);
+
+            /** \brief Add a value.
+             *  \param[in] value Value to add.
+             */
+            void add(double value);
+
+            /** \brief Get the number of values added.
+             *  \return The number of values.
+             */
+            std::size_t getCount() const;
+
+            /** \brief Get the quantile being estimated.
+             *  \return The quantile.
+             */
+            double getQuantile() const;
+
+            /** \brief Get the current estimate of the quantile.
+             *  \return The estimate, or NaN if no values have been added.
+             */
+            double get() const;
+
+        private:
+            double q_;                       ///< Quantile to estimate.
+            std::size_t count_{0};           ///< Number of values.
+            std::array<double, 5> height_;   ///< Marker heights.
+            std::array<double, 5> pos_;      ///< Actual marker positions.
+            std::array<double, 5> desired_;  ///< Desired marker positions.
+            std::array<double, 5> inc_;      ///< Increments of desired marker positions.
+        };
+    }  // namespace stats
+}  // namespace robowflex
+
+#endif
@@ -0,0 +1,89 @@
+/* Author: Zachary Kingston */
+
+#include <tuple>
+
+#include <robowflex_library/builder.h>
+#include <robowflex_library/collision_benchmark.h>
+#include <robowflex_library/detail/fetch.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/planning.h>
+#include <robowflex_library/scene.h>
+#include <robowflex_library/trajectory.h>
+#include <robowflex_library/util.h>
+
+using namespace robowflex;
+
+/* \file fetch_collision_benchmark.cpp
+ * Compares collision detector plugins on the example Fetch scenes in
+ * 'package://robowflex_library/yaml/fetch_scenes' and
+ * 'package://robowflex_library/yaml/fetch_box'. For each scene, a set of random
+ * states and the waypoints of a planned trajectory are replayed against every
+ * available collision detector using robowflex::CollisionBenchmark. Throughput
+ * and agreement are written to `collision_benchmark.csv`, and a detector is
+ * recommended for each type of scene.
+ */
+
+static const std::string GROUP = "arm_with_torso";
+static const std::size_t NUM_STATES = 1000;  // Random states per scene.
+
+int main(int argc, char **argv)
+{
+    // Startup ROS
+    ROS ros(argc, argv);
+
+    // Create the default Fetch robot.
+    auto fetch = std::make_shared<FetchRobot>();
+    fetch->initialize(false);
+
+    // Create the default planner for the Fetch.
+    auto planner = std::make_shared<OMPL::FetchOMPLPipelinePlanner>(fetch);
+    planner->initialize();
+
+    CollisionBenchmark benchmark;
+
+    // Scene type, and the directory and filename of its scenes.
+    const std::vector<std::tuple<std::string, std::string, std::string>> types{
+        {"vicon", "package://robowflex_library/yaml/fetch_scenes", "scene_vicon"},
+        {"box", "package://robowflex_library/yaml/fetch_box", "scene"}};
+
+    for (const auto &type : types)
+    {
+        const auto &prefix = std::get<0>(type);
+        for (std::size_t i = 1; i <= 10; i++)
+        {
+            const auto &scene_file =
+                log::format("%1%/%2%%3$04d.yaml", std::get<1>(type), std::get<2>(type), i);
+            const auto &request_file = log::format("%1%/request%2$04d.yaml", std::get<1>(type), i);
+            const auto &name = log::format("%1%%2$04d", prefix, i);
+
+            auto scene = std::make_shared<Scene>(fetch);
+            if (not scene->fromYAMLFile(scene_file))
+            {
+                RBX_ERROR("Failed to read file: %s for scene", scene_file);
+                continue;
+            }
+
+            benchmark.addScene(prefix, name + "_random", scene,
+                               CollisionBenchmark::sampleStates(fetch, GROUP, NUM_STATES, i));
+
+            // Replay a densely interpolated trajectory for the scene's request, if one can be found.
+            auto request = std::make_shared<MotionRequestBuilder>(planner, GROUP);
+            if (not request->fromYAMLFile(request_file))
+                continue;
+
+            const auto &response = planner->plan(scene, request->getRequest());
+            if (response.error_code_.val != moveit_msgs::MoveItErrorCodes::SUCCESS)
+                continue;
+
+            Trajectory trajectory(*response.trajectory_);
+            trajectory.interpolate(NUM_STATES);
+            benchmark.addScene(prefix, name + "_trajectory", scene, trajectory);
+        }
+    }
+
+    const auto &results = benchmark.run();
+    CollisionBenchmark::toCSVFile(results, "collision_benchmark.csv");
+    CollisionBenchmark::recommend(results);
+
+    return 0;
+}
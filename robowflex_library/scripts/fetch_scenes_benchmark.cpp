@@ -3,6 +3,7 @@
 // Robowflex
 #include <robowflex_library/benchmarking.h>
 #include <robowflex_library/builder.h>
+#include <robowflex_library/dataset.h>
 #include <robowflex_library/detail/fetch.h>
 #include <robowflex_library/log.h>
 #include <robowflex_library/planning.h>
@@ -16,7 +17,9 @@ using namespace robowflex;
  * requests for the Fetch robot. A number of example scene and planning request
  * pairs are included in 'package://robowflex_library/yaml/fetch_scenes'. This
  * script sets up benchmarking for all of these pairs. See
- * `fetch_scenes_visualize.cpp` to visualize these scenes.
+ * `fetch_scenes_visualize.cpp` to visualize these scenes. Pairs are loaded in
+ * the background with robowflex::DatasetLoader as benchmarking proceeds, so
+ * only a few scenes are in memory at a time.
  *
  * Benchmarking output is saved in the OMPL format. See
  * https://ompl.kavrakilab.org/benchmark.html for more information on the
@@ -42,48 +45,21 @@ int main(int argc, char **argv)
     options.metrics = Profiler::WAYPOINTS | Profiler::CORRECT | Profiler::LENGTH;
     Experiment experiment("fetch_scenes", options, 10.0, 10);
 
-    const std::size_t start = 1;
-    const std::size_t end = 10;
-    for (std::size_t i = start; i <= end; i++)
-    {
-        const auto &scene_file =
-            log::format("package://robowflex_library/yaml/fetch_scenes/scene_vicon%1$04d.yaml", i);
-        const auto &request_file =
-            log::format("package://robowflex_library/yaml/fetch_scenes/request%1$04d.yaml", i);
+    // Create the default planner for the Fetch.
+    auto planner = std::make_shared<OMPL::FetchOMPLPipelinePlanner>(fetch);
 
-        // Create an empty Scene.
-        auto scene = std::make_shared<Scene>(fetch);
-        if (not scene->fromYAMLFile(scene_file))
-        {
-            RBX_ERROR("Failed to read file: %s for scene", scene_file);
-            continue;
-        }
+    // Disable simplification
+    auto settings = OMPL::Settings();
+    settings.simplify_solutions = false;
 
-        // Create the default planner for the Fetch.
-        auto planner = std::make_shared<OMPL::FetchOMPLPipelinePlanner>(fetch);
+    planner->initialize(settings);
 
-        // Disable simplification
-        auto settings = OMPL::Settings();
-        settings.simplify_solutions = false;
-
-        planner->initialize(settings);
-
-        // Create an empty motion planning request.
-        auto request = std::make_shared<robowflex::MotionRequestBuilder>(planner, GROUP);
-        if (not request->fromYAMLFile(request_file))
-        {
-            RBX_ERROR("Failed to read file: %s for request", request_file);
-            continue;
-        }
-
-        // Add request
-        experiment.addQuery("vicon", scene, planner, request);
-    }
-
-    auto dataset = experiment.benchmark(4);
+    // Load all scene and request pairs in the background.
+    DatasetLoader loader(fetch, planner, GROUP);
+    loader.addDirectory("package://robowflex_library/yaml/fetch_scenes", "scene_vicon", "request");
 
     OMPLPlanDataSetOutputter output("robowflex");
-    output.dump(*dataset);
+    loader.benchmark(experiment, output, 4);
 
     return 0;
 }
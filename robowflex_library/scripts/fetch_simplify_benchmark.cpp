@@ -0,0 +1,119 @@
+/* Author: Zachary Kingston */
+
+#include <boost/lexical_cast.hpp>
+
+#include <robowflex_library/collision_benchmark.h>
+#include <robowflex_library/detail/fetch.h>
+#include <robowflex_library/geometry.h>
+#include <robowflex_library/io.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/scene.h>
+#include <robowflex_library/simplify.h>
+#include <robowflex_library/tf.h>
+#include <robowflex_library/util.h>
+
+using namespace robowflex;
+
+/* \file fetch_simplify_benchmark.cpp
+ * Measures the speedup and accuracy of collision checking against a mesh
+ * obstacle simplified with robowflex::MeshSimplifier. The mesh is placed in
+ * front of the Fetch, and random states are checked against the original mesh
+ * and each simplification. For each, the triangle count, checking time,
+ * speedup, agreement with the original, and missed collisions are reported.
+ *
+ * Usage: fetch_simplify_benchmark <mesh> [max error] [x y z]
+ */
+
+static const std::string GROUP = "arm_with_torso";
+static const std::size_t NUM_STATES = 5000;  // Random states to check.
+
+int main(int argc, char **argv)
+{
+    // Startup ROS
+    ROS ros(argc, argv);
+
+    const auto &args = ros.getArgs();
+    if (args.size() < 2)
+    {
+        RBX_ERROR("Usage: %1% <mesh> [max error] [x y z]", args[0]);
+        return 1;
+    }
+
+    const double max_error = (args.size() > 2) ? boost::lexical_cast<double>(args[2]) : 0.01;
+    const auto &pose = (args.size() > 5) ? TF::createPoseXYZ(boost::lexical_cast<double>(args[3]),  //
+                                                            boost::lexical_cast<double>(args[4]),  //
+                                                            boost::lexical_cast<double>(args[5])) :
+                                           TF::createPoseXYZ(0.8, 0, 0.8);
+
+    // Create the default Fetch robot.
+    auto fetch = std::make_shared<FetchRobot>();
+    fetch->initialize(false);
+
+    const auto &mesh = Geometry::makeMesh(args[1]);
+    if (not mesh->getShape())
+        return 1;
+
+    const auto &states = CollisionBenchmark::sampleStates(fetch, GROUP, NUM_STATES);
+
+    // Name and simplification method. The original mesh is checked first, as the reference.
+    std::vector<std::pair<std::string, MeshSimplifierPtr>> configurations{{"original", nullptr}};
+    for (const auto &method : {std::make_pair("decimate", MeshSimplifier::DECIMATE),
+                               std::make_pair("convex_hull", MeshSimplifier::CONVEX_HULL),
+                               std::make_pair("box", MeshSimplifier::BOX)})
+    {
+        MeshSimplifier::Options options;
+        options.method = method.second;
+        options.max_error = max_error;
+        options.min_triangles = 0;
+
+        configurations.emplace_back(method.first, std::make_shared<MeshSimplifier>(options));
+    }
+
+    double reference_time = 0;
+    std::vector<bool> reference;
+
+    for (const auto &configuration : configurations)
+    {
+        auto scene = std::make_shared<Scene>(fetch);
+        scene->setMeshSimplifier(configuration.second);
+        scene->updateCollisionObject("mesh", mesh, pose);
+
+        MeshSimplifier::Result result;
+        if (configuration.second)
+            result = configuration.second->simplify(mesh->getShape());
+
+        // Warm up any lazily initialized collision structures.
+        scene->checkCollision(*states[0]);
+
+        std::vector<bool> collisions(states.size());
+        const auto &start = IO::getDate();
+        for (std::size_t i = 0; i < states.size(); ++i)
+            collisions[i] = scene->checkCollision(*states[i]).collision;
+
+        const double time = IO::getSeconds(start, IO::getDate());
+
+        if (reference.empty())
+        {
+            reference = collisions;
+            reference_time = time;
+        }
+
+        std::size_t agree = 0, missed = 0;
+        for (std::size_t i = 0; i < states.size(); ++i)
+        {
+            agree += collisions[i] == reference[i];
+            missed += reference[i] and not collisions[i];
+        }
+
+        std::size_t triangles = static_cast<const shapes::Mesh &>(*mesh->getShape()).triangle_count;
+        if (result.simplified)
+            triangles = result.simplified_triangles;
+
+        RBX_INFO("%1%: %2% triangles, %3$.4fs, %4$.2fx speedup, %5$.2f%% agreement, %6% missed collisions, "
+                 "error bound %7%",
+                 configuration.first, triangles, time, reference_time / time,
+                 100. * agree / states.size(), missed, result.error);
+    }
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+/* Author: Zachary Kingston */
+
+#include <boost/lexical_cast.hpp>
+
+#include <robowflex_library/benchmarking.h>
+#include <robowflex_library/compare.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/util.h>
+
+using namespace robowflex;
+
+/* \file robowflex_compare.cpp
+ * Compares a candidate benchmark against a baseline with
+ * robowflex::PlanDataSetComparator, to gate changes on performance regressions.
+ * Both inputs can be JSON files from robowflex::JSONPlanDataSetOutputter or OMPL
+ * benchmark logs from robowflex::OMPLPlanDataSetOutputter.
+ *
+ * Usage: robowflex_compare <baseline> <candidate> [time threshold] [success threshold] [alpha]
+ *
+ * Exits with 1 if any regression is found, 2 if inputs could not be loaded, and 0 otherwise.
+ */
+
+int main(int argc, char **argv)
+{
+    // Startup ROS, without a spinner as no communication is needed.
+    ROS ros(argc, argv, "robowflex", 0);
+
+    const auto &args = ros.getArgs();
+    if (args.size() < 3)
+    {
+        RBX_ERROR("Usage: %1% <baseline> <candidate> [time threshold] [success threshold] [alpha]", args[0]);
+        return 2;
+    }
+
+    PlanDataSetComparator comparator;
+    auto &options = comparator.getOptions();
+    if (args.size() > 3)
+        options.time_threshold = boost::lexical_cast<double>(args[3]);
+    if (args.size() > 4)
+        options.success_threshold = boost::lexical_cast<double>(args[4]);
+    if (args.size() > 5)
+        options.alpha = boost::lexical_cast<double>(args[5]);
+
+    // Also compare path quality, where shorter paths are better.
+    options.metrics["length"] = false;
+
+    const auto &baseline = PlanDataSetLoader::fromFile(args[1]);
+    const auto &candidate = PlanDataSetLoader::fromFile(args[2]);
+    if (baseline.empty() or candidate.empty())
+    {
+        RBX_ERROR("Failed to load benchmark results!");
+        return 2;
+    }
+
+    const auto &comparisons = comparator.compare(baseline, candidate);
+    PlanDataSetComparator::report(comparisons);
+
+    if (PlanDataSetComparator::hasRegression(comparisons))
+    {
+        RBX_ERROR("Performance regressions found!");
+        return 1;
+    }
+
+    RBX_INFO("No performance regressions found.");
+    return 0;
+}
@@ -0,0 +1,53 @@
+/* Author: Zachary Kingston */
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <robowflex_library/benchmarking.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/util.h>
+
+using namespace robowflex;
+
+/* \file robowflex_merge.cpp
+ * Merges benchmark results that were split across machines or runs with
+ * robowflex::PlanDataSetLoader. Input files can be any mix of JSON files from
+ * robowflex::JSONPlanDataSetOutputter and OMPL benchmark logs from
+ * robowflex::OMPLPlanDataSetOutputter. Datasets with the same name are merged,
+ * and are written as JSON if the output ends in `.json`, or as OMPL benchmark
+ * logs with the output as a prefix otherwise.
+ *
+ * Usage: robowflex_merge <output> <runs per shard, 0 for no sharding> <files...>
+ */
+
+int main(int argc, char **argv)
+{
+    // Startup ROS, without a spinner as no communication is needed.
+    ROS ros(argc, argv, "robowflex", 0);
+
+    const auto &args = ros.getArgs();
+    if (args.size() < 4)
+    {
+        RBX_ERROR("Usage: %1% <output> <runs per shard> <files...>", args[0]);
+        return 1;
+    }
+
+    const auto &output = args[1];
+    const auto &shard_size = boost::lexical_cast<std::size_t>(args[2]);
+    const std::vector<std::string> files(args.begin() + 3, args.end());
+
+    std::size_t runs;
+    if (boost::algorithm::ends_with(output, ".json"))
+    {
+        JSONPlanDataSetOutputter json(output);
+        runs = PlanDataSetLoader::mergeFiles(files, json, shard_size);
+    }
+    else
+    {
+        OMPLPlanDataSetOutputter ompl(output);
+        runs = PlanDataSetLoader::mergeFiles(files, ompl, shard_size);
+    }
+
+    RBX_INFO("Merged %1% runs from %2% files into `%3%`", runs, files.size(), output);
+    return 0;
+}
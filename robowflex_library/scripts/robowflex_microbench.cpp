@@ -0,0 +1,262 @@
+/* Author: Zachary Kingston */
+
+#include <chrono>
+#include <cmath>
+
+#include <boost/lexical_cast.hpp>
+
+#include <moveit/robot_state/robot_state.h>
+#include <random_numbers/random_numbers.h>
+
+#include <robowflex_library/detail/fetch.h>
+#include <robowflex_library/detail/ur5.h>
+#include <robowflex_library/io.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/pool.h>
+#include <robowflex_library/robot.h>
+#include <robowflex_library/scene.h>
+#include <robowflex_library/statistics.h>
+#include <robowflex_library/trajectory.h>
+#include <robowflex_library/util.h>
+
+using namespace robowflex;
+
+/* \file robowflex_microbench.cpp
+ * Microbenchmarks of the core operations that dominate planning runtime: forward
+ * kinematics, collision checking, distance queries, IK, trajectory metrics, YAML
+ * input / output, and thread pool dispatch. Each benchmark is repeated a number
+ * of times and summarized with robowflex::stats. All random states are generated
+ * from a fixed seed so results are repeatable between runs.
+ *
+ * Usage: robowflex_microbench [output.json] [repetitions]
+ *
+ * Results (in seconds per operation) are written to a JSON file, by default
+ * `robowflex_microbench.json`, so they can be tracked per commit.
+ */
+
+static const std::size_t SEED = 42;          // Seed for random states.
+static const std::size_t NUM_STATES = 1000;  // Number of random states to cycle through.
+
+namespace
+{
+    /** Format a value as a JSON number, or null if it is not finite (e.g., the stddev of one repetition). */
+    std::string toJSONNumber(double value)
+    {
+        if (not std::isfinite(value))
+            return "null";
+
+        return boost::lexical_cast<std::string>(value);
+    }
+
+    /** Result of a single microbenchmark. */
+    struct Result
+    {
+        std::string name;        // Name of the benchmark.
+        std::size_t iterations;  // Operations per repetition.
+        stats::Summary summary;  // Summary of seconds per operation over repetitions.
+    };
+
+    /** Runs microbenchmarks and collects their results. */
+    class MicroBenchmark
+    {
+    public:
+        MicroBenchmark(std::size_t repetitions) : repetitions_(repetitions)
+        {
+        }
+
+        /** Run \a function \a iterations times per repetition, after a single warm-up call. */
+        template <typename F>
+        void run(const std::string &name, std::size_t iterations, F &&function)
+        {
+            function(0);
+
+            std::vector<double> times;
+            for (std::size_t r = 0; r < repetitions_; ++r)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                for (std::size_t i = 0; i < iterations; ++i)
+                    function(i);
+
+                const auto finish = std::chrono::steady_clock::now();
+                times.emplace_back(std::chrono::duration<double>(finish - start).count() / iterations);
+            }
+
+            Result result{name, iterations, stats::summarize(times)};
+            RBX_INFO("%1$-32s median %2$12.3f us  mean %3$12.3f us  stddev %4$10.3f us",  //
+                     name, result.summary.median * 1e6, result.summary.mean * 1e6,
+                     result.summary.stddev * 1e6);
+
+            results_.emplace_back(result);
+        }
+
+        /** Write all results to a JSON file. */
+        void toJSONFile(const std::string &file) const
+        {
+            std::ofstream out;
+            IO::createFile(out, file);
+
+            out << "{";
+            out << "\"hostname\":\"" << IO::getHostname() << "\",";
+            out << "\"date\":\"" << IO::getDate() << "\",";
+            out << "\"seed\":" << SEED << ",";
+            out << "\"repetitions\":" << repetitions_ << ",";
+            out << "\"benchmarks\":[";
+
+            for (std::size_t i = 0; i < results_.size(); ++i)
+            {
+                const auto &result = results_[i];
+                const auto &s = result.summary;
+
+                out << "{";
+                out << "\"name\":\"" << result.name << "\",";
+                out << "\"iterations\":" << result.iterations << ",";
+                out << "\"mean\":" << toJSONNumber(s.mean) << ",";
+                out << "\"stddev\":" << toJSONNumber(s.stddev) << ",";
+                out << "\"min\":" << toJSONNumber(s.min) << ",";
+                out << "\"q25\":" << toJSONNumber(s.q25) << ",";
+                out << "\"median\":" << toJSONNumber(s.median) << ",";
+                out << "\"q75\":" << toJSONNumber(s.q75) << ",";
+                out << "\"q95\":" << toJSONNumber(s.q95) << ",";
+                out << "\"max\":" << toJSONNumber(s.max);
+                out << "}";
+
+                if (i != results_.size() - 1)
+                    out << "," << std::endl;
+            }
+
+            out << "]}" << std::endl;
+            out.close();
+        }
+
+    private:
+        std::size_t repetitions_;      // Repetitions of each benchmark.
+        std::vector<Result> results_;  // Results so far.
+    };
+
+    /** Generate a set of random states for a group from a fixed seed. */
+    std::vector<robot_state::RobotStatePtr> getRandomStates(const RobotPtr &robot, const std::string &group)
+    {
+        random_numbers::RandomNumberGenerator rng(SEED);
+        const auto &jmg = robot->getModelConst()->getJointModelGroup(group);
+
+        std::vector<robot_state::RobotStatePtr> states;
+        for (std::size_t i = 0; i < NUM_STATES; ++i)
+        {
+            auto state = robot->allocState();
+            state->setToRandomPositions(jmg, rng);
+            state->update(true);
+
+            states.emplace_back(state);
+        }
+
+        return states;
+    }
+
+    /** Benchmark core operations for a robot, group and scene. */
+    void benchmarkRobot(MicroBenchmark &bench, const std::string &prefix, const RobotPtr &robot,
+                        const std::string &group, const ScenePtr &scene, const std::string &tip)
+    {
+        volatile double sink = 0;
+
+        const auto &states = getRandomStates(robot, group);
+        auto scratch = robot->allocState();
+
+        bench.run(prefix + "/fk", 10000, [&](std::size_t i) {
+            const auto &state = *states[i % states.size()];
+            scratch->setVariablePositions(state.getVariablePositions());
+            scratch->updateLinkTransforms();
+            sink = sink + scratch->getGlobalLinkTransform(tip).translation().x();
+        });
+
+        bench.run(prefix + "/check_collision", 1000, [&](std::size_t i) {
+            sink = sink + scene->checkCollision(*states[i % states.size()]).collision;
+        });
+
+        bench.run(prefix + "/distance_to_collision", 100, [&](std::size_t i) {
+            sink = sink + scene->distanceToCollision(*states[i % states.size()]);
+        });
+
+        bench.run(prefix + "/set_from_ik", 10, [&](std::size_t i) {
+            const auto &pose = states[i % states.size()]->getGlobalLinkTransform(tip);
+            sink = sink + robot->setFromIK(Robot::IKQuery(group, pose), *scratch);
+        });
+
+        Trajectory trajectory(robot, group);
+        for (std::size_t i = 0; i < 100; ++i)
+            trajectory.addSuffixWaypoint(*states[i]);
+
+        bench.run(prefix + "/trajectory_length", 1000, [&](std::size_t) {  //
+            sink = sink + trajectory.getLength();
+        });
+
+        bench.run(prefix + "/trajectory_smoothness", 1000, [&](std::size_t) {  //
+            sink = sink + trajectory.getSmoothness();
+        });
+
+        const auto &scene_file = "/tmp/" + IO::generateUUID() + ".yml";
+        const auto &trajectory_file = "/tmp/" + IO::generateUUID() + ".yml";
+
+        bench.run(prefix + "/scene_yaml_save", 10, [&](std::size_t) {  //
+            sink = sink + scene->toYAMLFile(scene_file);
+        });
+
+        auto loaded = std::make_shared<Scene>(robot);
+        bench.run(prefix + "/scene_yaml_load", 10, [&](std::size_t) {  //
+            sink = sink + loaded->fromYAMLFile(scene_file);
+        });
+
+        bench.run(prefix + "/trajectory_yaml_save", 10, [&](std::size_t) {  //
+            sink = sink + trajectory.toYAMLFile(trajectory_file);
+        });
+
+        Trajectory loaded_trajectory(robot, group);
+        bench.run(prefix + "/trajectory_yaml_load", 10, [&](std::size_t) {  //
+            sink = sink + loaded_trajectory.fromYAMLFile(*scratch, trajectory_file);
+        });
+
+        IO::deleteFile(scene_file);
+        IO::deleteFile(trajectory_file);
+    }
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    // Startup ROS
+    ROS ros(argc, argv);
+
+    const auto &args = ros.getArgs();
+    const std::string output = (args.size() > 1) ? args[1] : "robowflex_microbench.json";
+    const std::size_t repetitions = (args.size() > 2) ? boost::lexical_cast<std::size_t>(args[2]) : 20;
+
+    MicroBenchmark bench(repetitions);
+
+    // Create the default UR5 robot with the bundled test scene.
+    auto ur5 = std::make_shared<UR5Robot>();
+    ur5->initialize();
+
+    auto ur5_scene = std::make_shared<Scene>(ur5);
+    ur5_scene->fromYAMLFile("package://robowflex_library/yaml/test.yml");
+
+    benchmarkRobot(bench, "ur5", ur5, "manipulator", ur5_scene, "ee_link");
+
+    // Create the default Fetch robot with a bundled scene.
+    auto fetch = std::make_shared<FetchRobot>();
+    fetch->initialize(false);
+
+    auto fetch_scene = std::make_shared<Scene>(fetch);
+    fetch_scene->fromYAMLFile("package://robowflex_library/yaml/fetch_scenes/scene_vicon0001.yaml");
+
+    benchmarkRobot(bench, "fetch", fetch, "arm_with_torso", fetch_scene, "wrist_roll_link");
+
+    // Thread pool dispatch overhead for an empty job.
+    Pool pool(1);
+    volatile int sink = 0;
+    bench.run("pool/dispatch", 10000, [&](std::size_t) {
+        sink = sink + pool.submit(make_function([] { return 1; }))->get();
+    });
+
+    bench.toJSONFile(output);
+    RBX_INFO("Wrote results to `%1%`.", output);
+
+    return 0;
+}
@@ -0,0 +1,277 @@
+/* Author: Zachary Kingston */
+
+#include <iostream>
+
+#include <random_numbers/random_numbers.h>
+
+#include <robowflex_library/benchmarking.h>
+#include <robowflex_library/builder.h>
+#include <robowflex_library/detail/fetch.h>
+#include <robowflex_library/detail/ur5.h>
+#include <robowflex_library/generator.h>
+#include <robowflex_library/io/gnuplot.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/planning.h>
+#include <robowflex_library/scene.h>
+#include <robowflex_library/statistics.h>
+#include <robowflex_library/util.h>
+
+using namespace robowflex;
+
+/* \file scaling_benchmark.cpp
+ * A benchmarking suite that measures how planning scales with problem size
+ * before a deployment grows. Three sweeps are run using robowflex::Experiment:
+ * - Obstacle count, with obstacles around the UR5 from robowflex::SceneGenerator.
+ * - Robot degrees-of-freedom, over the UR5, Fetch, and WAM7 (if installed).
+ * - Benchmarking thread count, on a fixed UR5 query.
+ *
+ * For each sweep point, the median planning latency and throughput (completed
+ * plans per second of wall-clock time) are computed, and a power law is fit to
+ * each curve to get a scaling exponent. Raw results are output in the JSON and
+ * OMPL benchmark log formats, and each curve is plotted with GNUPlot.
+ */
+
+static const double TIME = 5.0;        // Allowed planning time per query.
+static const std::size_t TRIALS = 20;  // Trials per sweep point.
+static const std::size_t SEED = 42;    // Seed for random states and scenes.
+
+namespace
+{
+    /** A robot, group, and planner to benchmark. */
+    struct Target
+    {
+        std::string name;    // Name of the target.
+        RobotPtr robot;      // Robot.
+        std::string group;   // Planning group.
+        PlannerPtr planner;  // Planner.
+    };
+
+    /** A measurement at one point of a sweep. */
+    struct SweepPoint
+    {
+        double x;           // Swept parameter.
+        double latency;     // Median planning time.
+        double throughput;  // Completed plans per second.
+        double success;     // Success rate.
+    };
+
+    /** Sample a random collision-free state for a group. */
+    bool sampleValidState(const Target &target, const ScenePtr &scene,
+                          random_numbers::RandomNumberGenerator &rng, robot_state::RobotState &state)
+    {
+        const auto &jmg = target.robot->getModelConst()->getJointModelGroup(target.group);
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            state.setToRandomPositions(jmg, rng);
+            state.update(true);
+
+            if (not scene->checkCollision(state).collision)
+                return true;
+        }
+
+        return false;
+    }
+
+    /** Benchmark a query and summarize latency and throughput. */
+    SweepPoint runPoint(const std::string &name, double x, const Target &target, const ScenePtr &scene,
+                        const robot_state::RobotState &start, const robot_state::RobotState &goal,
+                        std::size_t threads, std::vector<PlanDataSetOutputter *> outputs)
+    {
+        auto request = std::make_shared<MotionRequestBuilder>(target.planner, target.group);
+        request->setStartConfiguration(start);
+        request->setGoalConfiguration(goal);
+        request->setConfig("RRTConnect");
+
+        Profiler::Options options;
+        options.metrics = Profiler::WAYPOINTS | Profiler::LENGTH;
+
+        Experiment experiment(name, options, TIME, TRIALS);
+        experiment.addQuery(target.name, scene, target.planner, request);
+
+        auto dataset = experiment.benchmark(threads);
+        for (auto &output : outputs)
+            output->dump(*dataset);
+
+        std::vector<double> times;
+        std::size_t successes = 0;
+        for (const auto &run : dataset->getFlatData())
+        {
+            times.emplace_back(run->time);
+            successes += run->success;
+        }
+
+        SweepPoint point;
+        point.x = x;
+        point.latency = stats::quantile(times, 0.5);
+        point.throughput = times.size() / dataset->time;
+        point.success = (times.empty()) ? 0. : double(successes) / times.size();
+
+        RBX_INFO("%1%: x = %2%, median latency = %3%s, throughput = %4% plans/s, success = %5%",  //
+                 name, x, point.latency, point.throughput, point.success);
+
+        return point;
+    }
+
+    /** Fit scaling exponents to a sweep and plot its curves. */
+    void report(IO::GNUPlotHelper &plot, const std::string &name, const std::string &xlabel,
+                const std::vector<SweepPoint> &sweep)
+    {
+        std::vector<double> x, latency, throughput;
+        IO::GNUPlotHelper::Series latency_series, throughput_series;
+        for (const auto &point : sweep)
+        {
+            x.emplace_back(point.x);
+            latency.emplace_back(point.latency);
+            throughput.emplace_back(point.throughput);
+
+            latency_series.emplace_back(point.x, point.latency);
+            throughput_series.emplace_back(point.x, point.throughput);
+        }
+
+        const auto &lfit = stats::fitPowerLaw(x, latency);
+        const auto &tfit = stats::fitPowerLaw(x, throughput);
+
+        RBX_INFO("%1%: latency ~ %2% * x^%3% (R^2 = %4%), throughput ~ %5% * x^%6% (R^2 = %7%)",  //
+                 name, lfit.coefficient, lfit.exponent, lfit.r2, tfit.coefficient, tfit.exponent, tfit.r2);
+
+        IO::GNUPlotHelper::TimeSeriesOptions latency_options;
+        latency_options.instance = name + "_latency";
+        latency_options.title = log::format("Latency scaling for %1% (exponent %2%)", name, lfit.exponent);
+        latency_options.x.label = xlabel;
+        latency_options.x.log = true;
+        latency_options.y.label = "Median planning time (s)";
+        latency_options.y.log = true;
+        latency_options.points.emplace("latency", latency_series);
+
+        IO::GNUPlotHelper::TimeSeriesOptions throughput_options;
+        throughput_options.instance = name + "_throughput";
+        throughput_options.title =
+            log::format("Throughput scaling for %1% (exponent %2%)", name, tfit.exponent);
+        throughput_options.x.label = xlabel;
+        throughput_options.x.log = true;
+        throughput_options.y.label = "Plans per second";
+        throughput_options.y.log = true;
+        throughput_options.points.emplace("throughput", throughput_series);
+
+        try
+        {
+            plot.timeseries(latency_options);
+            plot.timeseries(throughput_options);
+        }
+        catch (Exception &e)
+        {
+            RBX_WARN("Could not plot results: %1%", e.what());
+        }
+    }
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    // Startup ROS
+    ROS ros(argc, argv);
+
+    random_numbers::RandomNumberGenerator rng(SEED);
+
+    JSONPlanDataSetOutputter json("scaling.json");
+    OMPLPlanDataSetOutputter ompl("scaling");
+    std::vector<PlanDataSetOutputter *> outputs{&json, &ompl};
+
+    IO::GNUPlotHelper plot;
+
+    // Create the default UR5 robot and planner.
+    auto ur5 = std::make_shared<UR5Robot>();
+    ur5->initialize();
+
+    auto ur5_planner = std::make_shared<OMPL::UR5OMPLPipelinePlanner>(ur5);
+    ur5_planner->initialize();
+
+    Target ur5_target{"ur5", ur5, "manipulator", ur5_planner};
+
+    // Create the default Fetch robot and planner.
+    auto fetch = std::make_shared<FetchRobot>();
+    fetch->initialize(false);
+
+    auto fetch_planner = std::make_shared<OMPL::FetchOMPLPipelinePlanner>(fetch);
+    fetch_planner->initialize();
+
+    std::vector<Target> targets{ur5_target, {"fetch", fetch, "arm_with_torso", fetch_planner}};
+
+    // Create the WAM7 robot and planner, if available.
+    auto wam7 = std::make_shared<Robot>("wam7");
+    if (wam7->initialize("package://barrett_model/robots/wam7_bhand.urdf.xacro",          // urdf
+                         "package://barrett_wam_moveit_config/config/wam7_hand.srdf",     // srdf
+                         "package://barrett_wam_moveit_config/config/joint_limits.yaml",  // joint limits
+                         "package://barrett_wam_moveit_config/config/kinematics.yaml"     // kinematics
+                         ))
+    {
+        wam7->loadKinematics("arm");
+
+        auto wam7_planner = std::make_shared<OMPL::OMPLPipelinePlanner>(wam7);
+        wam7_planner->initialize("package://barrett_wam_moveit_config/config/ompl_planning.yaml");
+        targets.push_back({"wam7", wam7, "arm", wam7_planner});
+    }
+    else
+        RBX_WARN("WAM7 is not available, skipping in degrees-of-freedom sweep.");
+
+    // UR5 start and goal in an empty scene, used for the obstacle and thread sweeps.
+    auto empty = std::make_shared<Scene>(ur5);
+    auto ur5_start = ur5->allocState();
+    auto ur5_goal = ur5->allocState();
+    sampleValidState(ur5_target, empty, rng, *ur5_start);
+    sampleValidState(ur5_target, empty, rng, *ur5_goal);
+
+    // Sweep over number of obstacles.
+    SceneGenerator::Options generator_options;
+    generator_options.max_size = Eigen::Vector3d::Constant(0.2);
+    SceneGenerator generator(ur5, "manipulator", generator_options);
+
+    std::vector<SweepPoint> obstacles;
+    for (const std::size_t n : {1, 2, 4, 8, 16, 32, 64})
+    {
+        auto scene = std::make_shared<Scene>(ur5);
+        generator.getOptions().obstacles = n;
+        generator.addObstacles(SEED + n, scene, {ur5_start, ur5_goal});
+
+        const double x = scene->getCollisionObjects().size();
+        obstacles.emplace_back(runPoint(log::format("obstacles_%1%", n), x, ur5_target, scene,  //
+                                        *ur5_start, *ur5_goal, 1, outputs));
+    }
+
+    report(plot, "obstacles", "Number of obstacles", obstacles);
+
+    // Sweep over robot degrees-of-freedom.
+    std::vector<SweepPoint> dof;
+    for (const auto &target : targets)
+    {
+        auto scene = std::make_shared<Scene>(target.robot);
+        auto start = target.robot->allocState();
+        auto goal = target.robot->allocState();
+        if (not sampleValidState(target, scene, rng, *start)  //
+            or not sampleValidState(target, scene, rng, *goal))
+        {
+            RBX_ERROR("Failed to sample valid states for %1%!", target.name);
+            continue;
+        }
+
+        const auto &jmg = target.robot->getModelConst()->getJointModelGroup(target.group);
+        const double x = jmg->getVariableCount();
+        dof.emplace_back(runPoint(log::format("dof_%1%", target.name), x, target, scene,  //
+                                  *start, *goal, 1, outputs));
+    }
+
+    std::sort(dof.begin(), dof.end(), [](const SweepPoint &a, const SweepPoint &b) { return a.x < b.x; });
+    report(plot, "dof", "Degrees of freedom", dof);
+
+    // Sweep over number of benchmarking threads.
+    std::vector<SweepPoint> threads;
+    for (std::size_t n = 1; n <= std::thread::hardware_concurrency(); n *= 2)
+        threads.emplace_back(runPoint(log::format("threads_%1%", n), n, ur5_target, empty,  //
+                                      *ur5_start, *ur5_goal, n, outputs));
+
+    report(plot, "threads", "Number of threads", threads);
+
+    RBX_INFO("Press Enter to Exit...");
+    std::cin.ignore();
+
+    return 0;
+}
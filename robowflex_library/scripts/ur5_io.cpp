@@ -2,6 +2,7 @@
 
 #include <robowflex_library/detail/ur5.h>
 #include <robowflex_library/io/bag.h>
+#include <robowflex_library/log.h>
 #include <robowflex_library/scene.h>
 #include <robowflex_library/util.h>
 
@@ -38,5 +39,14 @@ int main(int argc, char **argv)
         auto msgs = bag_in.getMessages<moveit_msgs::PlanningScene>({"scene"});
     }
 
+    // Stream the same scene from the rosbag file, decoding messages only as they are reached.
+    {
+        IO::Bag bag_in("scene.bag", IO::Bag::READ);
+
+        IO::Bag::Stream<moveit_msgs::PlanningScene> stream(bag_in, {"scene"});
+        for (const auto &message : stream)
+            RBX_INFO("Read scene `%1%` at %2%", message.msg->name, message.time);
+    }
+
     return 0;
 }
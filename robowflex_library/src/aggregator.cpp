@@ -0,0 +1,209 @@
+/* Author: Zachary Kingston */
+
+#include <cmath>
+#include <cstdio>  // for std::rename
+#include <fstream>
+
+#include <robowflex_library/aggregator.h>
+#include <robowflex_library/io.h>
+#include <robowflex_library/log.h>
+
+using namespace robowflex;
+
+namespace
+{
+    /** Write a double as a JSON value, as JSON has no representation of non-finite numbers. */
+    std::string toJSONNumber(double value)
+    {
+        return (std::isfinite(value)) ? log::format("%1%", value) : "null";
+    }
+}  // namespace
+
+///
+/// StreamingAggregator::QuerySummary
+///
+
+double StreamingAggregator::QuerySummary::getSuccessRate() const
+{
+    return (runs > 0) ? double(successes) / runs : 0.;
+}
+
+///
+/// StreamingAggregator
+///
+
+StreamingAggregator::StreamingAggregator(const std::vector<double> &quantiles) : quantiles_(quantiles)
+{
+}
+
+void StreamingAggregator::addValue(QuerySummary &summary, const std::string &metric, double value)
+{
+    auto it = summary.metrics.find(metric);
+    if (it == summary.metrics.end())
+    {
+        MetricSummary metric_summary;
+        for (const auto &q : quantiles_)
+            metric_summary.quantiles.emplace_back(q);
+
+        it = summary.metrics.emplace(metric, metric_summary).first;
+    }
+
+    it->second.moments.add(value);
+    for (auto &quantile : it->second.quantiles)
+        quantile.add(value);
+}
+
+void StreamingAggregator::add(const std::string &key, const PlanData &run)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto &summary = summaries_[key];
+
+    summary.runs++;
+    summary.successes += run.success;
+    addValue(summary, "time", run.time);
+
+    for (const auto &metric : run.metrics)
+    {
+        // Only numeric metrics are summarized.
+        if (boost::get<std::string>(&metric.second))
+            continue;
+
+        const double value = toMetricDouble(metric.second);
+        if (std::isfinite(value))
+            addValue(summary, metric.first, value);
+    }
+}
+
+Experiment::PostQueryCallback StreamingAggregator::getCallback()
+{
+    return [this](PlanDataSetPtr dataset, const PlanningQuery &query) {
+        // The callback is called right after the run is added, so it is the last run of the query.
+        const auto &it = dataset->data.find(query.name);
+        if (it == dataset->data.end() or it->second.empty())
+            return;
+
+        auto key = query.name;
+        if (not query.request.planner_id.empty())
+            key += " (" + query.request.planner_id + ")";
+
+        add(key, *it->second.back());
+    };
+}
+
+std::map<std::string, StreamingAggregator::QuerySummary> StreamingAggregator::getSummaries() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return summaries_;
+}
+
+bool StreamingAggregator::hasConverged(const std::string &key, double tolerance, std::size_t min_runs,
+                                       const std::string &metric) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    const auto &summary = summaries_.find(key);
+    if (summary == summaries_.end())
+        return false;
+
+    const auto &it = summary->second.metrics.find(metric);
+    if (it == summary->second.metrics.end())
+        return false;
+
+    const auto &moments = it->second.moments;
+    if (moments.getCount() < std::max<std::size_t>(min_runs, 2))
+        return false;
+
+    // Half-width of the 95% confidence interval of the mean, by the normal approximation.
+    const double half_width = 1.96 * moments.getStandardDeviation() / std::sqrt(moments.getCount());
+    return half_width <= tolerance * std::abs(moments.getMean());
+}
+
+void StreamingAggregator::report() const
+{
+    for (const auto &summary : getSummaries())
+    {
+        const auto &s = summary.second;
+        RBX_INFO("%1%: %2% runs, %3$.1f%% success", summary.first, s.runs, s.getSuccessRate() * 100.);
+
+        for (const auto &metric : s.metrics)
+        {
+            const auto &m = metric.second;
+
+            std::string quantiles;
+            for (const auto &q : m.quantiles)
+                quantiles += log::format(" q%1%=%2%", q.getQuantile(), q.get());
+
+            RBX_INFO("  %1%: mean=%2% stddev=%3% min=%4% max=%5%%6%",  //
+                     metric.first, m.moments.getMean(), m.moments.getStandardDeviation(),
+                     m.moments.getMin(), m.moments.getMax(), quantiles);
+        }
+    }
+}
+
+bool StreamingAggregator::toJSONFile(const std::string &file) const
+{
+    const auto &summaries = getSummaries();
+
+    // Write to a temporary file first, and then move it over the output.
+    const auto &temporary = file + ".tmp";
+
+    std::ofstream out;
+    IO::createFile(out, temporary);
+    if (not out)
+    {
+        RBX_ERROR("Failed to open `%1%` for writing", temporary);
+        return false;
+    }
+
+    out << "{";
+    for (auto it = summaries.begin(); it != summaries.end(); ++it)
+    {
+        const auto &s = it->second;
+        if (it != summaries.begin())
+            out << ",";
+
+        out << "\"" << it->first << "\":{";
+        out << "\"runs\":" << s.runs << ",";
+        out << "\"successes\":" << s.successes << ",";
+        out << "\"success_rate\":" << s.getSuccessRate() << ",";
+        out << "\"metrics\":{";
+
+        for (auto jt = s.metrics.begin(); jt != s.metrics.end(); ++jt)
+        {
+            const auto &m = jt->second;
+            if (jt != s.metrics.begin())
+                out << ",";
+
+            out << "\"" << jt->first << "\":{";
+            out << "\"count\":" << m.moments.getCount() << ",";
+            out << "\"mean\":" << toJSONNumber(m.moments.getMean()) << ",";
+            out << "\"stddev\":" << toJSONNumber(m.moments.getStandardDeviation()) << ",";
+            out << "\"min\":" << toJSONNumber(m.moments.getMin()) << ",";
+            out << "\"max\":" << toJSONNumber(m.moments.getMax()) << ",";
+            out << "\"quantiles\":{";
+
+            for (std::size_t i = 0; i < m.quantiles.size(); ++i)
+            {
+                if (i != 0)
+                    out << ",";
+
+                out << "\"" << m.quantiles[i].getQuantile() << "\":" << toJSONNumber(m.quantiles[i].get());
+            }
+
+            out << "}}";
+        }
+
+        out << "}}" << std::endl;
+    }
+
+    out << "}" << std::endl;
+    out.close();
+
+    if (std::rename(temporary.c_str(), file.c_str()) != 0)
+    {
+        RBX_ERROR("Failed to move `%1%` to `%2%`", temporary, file);
+        return false;
+    }
+
+    return true;
+}
@@ -1,7 +1,13 @@
 /* Author: Zachary Kingston, Bryce Willey */
 
+#include <cmath>
+#include <limits>
 #include <queue>
+#include <regex>
+#include <set>
+#include <sstream>
 
+#include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 #include <utility>
 
@@ -14,7 +20,9 @@
 #include <robowflex_library/io.h>
 #include <robowflex_library/io/yaml.h>
 #include <robowflex_library/log.h>
+#include <robowflex_library/perf.h>
 #include <robowflex_library/planning.h>
+#include <robowflex_library/pool.h>
 #include <robowflex_library/scene.h>
 #include <robowflex_library/trajectory.h>
 
@@ -65,6 +73,50 @@ std::string robowflex::toMetricString(const PlannerMetric &metric)
     return boost::apply_visitor(toMetricStringVisitor(), metric);
 }
 
+namespace
+{
+    class toMetricDoubleVisitor : public boost::static_visitor<double>
+    {
+    public:
+        double operator()(int value) const
+        {
+            return value;
+        }
+
+        double operator()(std::size_t value) const
+        {
+            return value;
+        }
+
+        double operator()(double value) const
+        {
+            return value;
+        }
+
+        double operator()(bool value) const
+        {
+            return value;
+        }
+
+        double operator()(const std::string &value) const
+        {
+            try
+            {
+                return boost::lexical_cast<double>(value);
+            }
+            catch (boost::bad_lexical_cast &)
+            {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+    };
+}  // namespace
+
+double robowflex::toMetricDouble(const PlannerMetric &metric)
+{
+    return boost::apply_visitor(toMetricDoubleVisitor(), metric);
+}
+
 ///
 /// PlanningQuery
 ///
@@ -82,11 +134,13 @@ PlanningQuery::PlanningQuery(const std::string &name,     //
 ///
 
 std::vector<std::pair<double, double>> PlanData::getProgressPropertiesAsPoints(const std::string &xprop,
-                                                                               const std::string &yprop) const
+                                                                               const std::string &yprop,
+                                                                               std::size_t start) const
 {
     std::vector<std::pair<double, double>> ret;
-    for (const auto &point : progress)
+    for (std::size_t i = start; i < progress.size(); ++i)
     {
+        const auto &point = progress[i];
         auto xit = point.find(xprop);
         if (xit == point.end())
             break;
@@ -212,8 +266,36 @@ bool Profiler::profilePlan(const PlannerPtr &planner,
         }));
     }
 
+    // Setup performance counters after the progress thread is spawned, so it is not counted.
+    std::shared_ptr<PerfCounters> counters;
+    if (options.counters)
+    {
+        counters = std::make_shared<PerfCounters>();
+        counters->start();
+
+        // Time the same span as the counters, without opening them.
+        std::unique_lock<std::mutex> lock(mutex);
+        result.start = IO::getDate();
+    }
+
     // Plan
     result.response = planner->plan(scene, request);
+    result.finish = IO::getDate();
+
+    if (counters)
+    {
+        const auto &sample = counters->stop();
+        for (std::size_t i = 0; i < PerfCounters::NUM_COUNTERS; ++i)
+        {
+            const auto counter = static_cast<PerfCounters::Counter>(i);
+            result.metrics[log::format("perf_%1%", PerfCounters::getName(counter))] =
+                static_cast<std::size_t>(sample.values[i]);
+        }
+
+        result.metrics["perf_available"] = sample.anyAvailable();
+        result.metrics["cpu_user_time"] = sample.user_time;
+        result.metrics["cpu_system_time"] = sample.system_time;
+    }
 
     // Notify planner progress thread
     {
@@ -222,7 +304,6 @@ bool Profiler::profilePlan(const PlannerPtr &planner,
     }
 
     // Compute metrics and fill out results
-    result.finish = IO::getDate();
     result.time = IO::getSeconds(result.start, result.finish);
     result.success = result.response.error_code_.val == moveit_msgs::MoveItErrorCodes::SUCCESS;
 
@@ -279,6 +360,12 @@ void Profiler::computeBuiltinMetrics(uint32_t options, const SceneConstPtr &scen
     if (options & Metrics::SMOOTHNESS)
         run.metrics["smoothness"] = run.success ? run.trajectory->getSmoothness() : 0.0;
 
+    // Overshoot of the requested planning time. Negative values are slack.
+    const double allowed = run.query.request.allowed_planning_time;
+    run.metrics["deadline_overshoot"] = run.time - allowed;
+    run.metrics["deadline_overshoot_ratio"] = (allowed > 0.) ? (run.time - allowed) / allowed : 0.;
+    run.metrics["deadline_exceeded"] = run.time > allowed;
+
     run.metrics["robowflex_planner_name"] = run.query.planner->getName();
     run.metrics["robowflex_robot_name"] = run.query.planner->getRobot()->getName();
 
@@ -355,6 +442,11 @@ const std::vector<PlanningQuery> &Experiment::getQueries() const
     return queries_;
 }
 
+void Experiment::clearQueries()
+{
+    queries_.clear();
+}
+
 void Experiment::enableMultipleRequests()
 {
     enforce_single_thread_ = false;
@@ -365,6 +457,11 @@ void Experiment::overridePlanningTime()
     override_planning_time_ = false;
 }
 
+void Experiment::setWarmupRuns(std::size_t runs)
+{
+    warmup_runs_ = runs;
+}
+
 void Experiment::setPreRunCallback(const PreRunCallback &callback)
 {
     pre_callback_ = callback;
@@ -380,12 +477,92 @@ void Experiment::setPostQueryCallback(const PostQueryCallback &callback)
     complete_callback_ = callback;
 }
 
+double Experiment::getAllowedTime(const PlanningQuery &query) const
+{
+    // If override, use global time. Else use query time.
+    return (override_planning_time_) ? allowed_time_ : query.request.allowed_planning_time;
+}
+
+PlanDataPtr Experiment::profileQuery(const PlanningQuery &query, double time, bool callbacks) const
+{
+    planning_interface::MotionPlanRequest request = query.request;
+    request.allowed_planning_time = time;
+
+    if (enforce_single_thread_)
+        request.num_planning_attempts = 1;
+
+    // Call pre-run callbacks
+    const auto prerun_start = IO::getDate();
+    query.planner->preRun(query.scene, request);
+    const double prerun_time = IO::getSeconds(prerun_start, IO::getDate());
+
+    if (callbacks and pre_callback_)
+        pre_callback_(query);
+
+    // Profile query
+    auto data = std::make_shared<PlanData>();
+    profiler_.profilePlan(query.planner,  //
+                          query.scene,    //
+                          request,        //
+                          options_,       //
+                          *data);
+
+    data->metrics.emplace("query_prerun_time", prerun_time);
+    return data;
+}
+
+PlanDataSetPtr Experiment::warmup() const
+{
+    auto dataset = std::make_shared<PlanDataSet>();
+    dataset->name = name_ + "_warmup";
+    dataset->start = IO::getDate();
+    dataset->allowed_time = allowed_time_;
+    dataset->trials = warmup_runs_;
+    dataset->enforced_single_thread = enforce_single_thread_;
+    dataset->run_till_timeout = false;
+    dataset->threads = 1;
+
+    // Only warm-up the first query of each planner and scene pair, as that is where setup costs are paid.
+    std::set<std::pair<const Planner *, const Scene *>> seen;
+    for (std::size_t i = 0; i < queries_.size(); ++i)
+    {
+        const auto &query = queries_[i];
+        if (not seen.emplace(query.planner.get(), query.scene.get()).second)
+            continue;
+
+        dataset->queries.emplace_back(query);
+        const auto &it = std::find(dataset->query_names.begin(), dataset->query_names.end(), query.name);
+        if (it == dataset->query_names.end())
+            dataset->query_names.emplace_back(query.name);
+
+        for (std::size_t j = 0; j < warmup_runs_; ++j)
+        {
+            RBX_INFO("Warming up Query %2% `%1%` Run [%3%/%4%]", query.name, i, j + 1, warmup_runs_);
+
+            auto data = profileQuery(query, getAllowedTime(query), false);
+            data->metrics.emplace("query_trial", (int)j);
+            data->metrics.emplace("query_index", (int)i);
+            data->metrics.emplace("query_timeout_trial", (int)0);
+            data->metrics.emplace("query_start_time", IO::getSeconds(dataset->start, data->start));
+            data->metrics.emplace("query_finish_time", IO::getSeconds(dataset->start, data->finish));
+            data->metrics.emplace("query_cold_start", j == 0);
+
+            data->query.name = log::format("%1%:%2%:%3%", query.name, j, i);
+            dataset->addDataPoint(query.name, data);
+        }
+    }
+
+    dataset->finish = IO::getDate();
+    dataset->time = IO::getSeconds(dataset->start, dataset->finish);
+
+    return dataset;
+}
+
 PlanDataSetPtr Experiment::benchmark(std::size_t n_threads) const
 {
     // Setup dataset to return
     auto dataset = std::make_shared<PlanDataSet>();
     dataset->name = name_;
-    dataset->start = IO::getDate();
     dataset->allowed_time = allowed_time_;
     dataset->trials = trials_;
     dataset->enforced_single_thread = enforce_single_thread_;
@@ -393,6 +570,12 @@ PlanDataSetPtr Experiment::benchmark(std::size_t n_threads) const
     dataset->threads = n_threads;
     dataset->queries = queries_;
 
+    // Warm up before the start time is taken, so it is not counted in the experiment time.
+    if (warmup_runs_ > 0)
+        dataset->warmup = warmup();
+
+    dataset->start = IO::getDate();
+
     struct ThreadInfo
     {
         ThreadInfo() = default;
@@ -445,32 +628,12 @@ PlanDataSetPtr Experiment::benchmark(std::size_t n_threads) const
                 RBX_INFO("[Thread %1%] Running Query %3% `%2%` Trial [%4%/%5%]",  //
                          id, info.query->name, info.index, info.trial + 1, trials_);
 
-                // If override, use global time. Else use query time.
-                double time_remaining =
-                    (override_planning_time_) ? allowed_time_ : info.query->request.allowed_planning_time;
+                double time_remaining = getAllowedTime(*info.query);
 
                 std::size_t timeout_trial = 0;
                 while (time_remaining > 0.)
                 {
-                    planning_interface::MotionPlanRequest request = info.query->request;
-                    request.allowed_planning_time = time_remaining;
-
-                    if (enforce_single_thread_)
-                        request.num_planning_attempts = 1;
-
-                    // Call pre-run callbacks
-                    info.query->planner->preRun(info.query->scene, request);
-
-                    if (pre_callback_)
-                        pre_callback_(*info.query);
-
-                    // Profile query
-                    auto data = std::make_shared<PlanData>();
-                    profiler_.profilePlan(info.query->planner,  //
-                                          info.query->scene,    //
-                                          request,              //
-                                          options_,             //
-                                          *data);
+                    auto data = profileQuery(*info.query, time_remaining, true);
 
                     // Add experiment specific metrics
                     data->metrics.emplace("query_trial", (int)info.trial);
@@ -529,6 +692,37 @@ PlanDataSetPtr Experiment::benchmark(std::size_t n_threads) const
 /// JSONPlanDataSetOutputter
 ///
 
+namespace
+{
+    /** Convert a metric to a JSON value that keeps its type. Booleans are written as `true` or `false`,
+     *  doubles always have a decimal point or exponent, and strings are quoted. */
+    std::string toJSONMetricString(const PlannerMetric &metric)
+    {
+        const auto &value = toMetricString(metric);
+
+        if (const auto *b = boost::get<bool>(&metric))
+            return *b ? "true" : "false";
+
+        if (boost::get<double>(&metric))
+            return (value.find_first_of(".eE") == std::string::npos) ? value + ".0" : value;
+
+        if (boost::get<std::string>(&metric))
+        {
+            std::string quoted = "\"";
+            for (const auto &c : value)
+            {
+                if (c == '"' or c == '\\')
+                    quoted += '\\';
+                quoted += c;
+            }
+
+            return quoted + "\"";
+        }
+
+        return value;
+    }
+}  // namespace
+
 JSONPlanDataSetOutputter::JSONPlanDataSetOutputter(const std::string &file) : file_(file)
 {
 }
@@ -566,7 +760,7 @@ void JSONPlanDataSetOutputter::dump(const PlanDataSet &results)
         outfile_ << "\"success\":" << run->success;
 
         for (const auto &metric : run->metrics)
-            outfile_ << ",\"" << metric.first << "\":" << toMetricString(metric.second);
+            outfile_ << ",\"" << metric.first << "\":" << toJSONMetricString(metric.second);
 
         outfile_ << "}";
 
@@ -647,15 +841,32 @@ void OMPLPlanDataSetOutputter::dump(const PlanDataSet &results)
     {
         const auto &runs = results.data.find(name)->second;
 
+        // Runs may have different metrics, e.g., after merging datasets. Use the union of metrics over all
+        // runs, with a metric being REAL if it is a double in any run.
+        std::map<std::string, PlannerMetric> types;
+        std::vector<std::string> progress_names;
+        for (const auto &run : runs)
+        {
+            for (const auto &metric : run->metrics)
+            {
+                const auto &it = types.find(metric.first);
+                if (it == types.end() or boost::get<double>(&metric.second))
+                    types[metric.first] = metric.second;
+            }
+
+            for (const auto &property : run->property_names)
+                if (std::find(progress_names.begin(), progress_names.end(), property) == progress_names.end())
+                    progress_names.emplace_back(property);
+        }
+
         out << name << std::endl;  // planner_name
         out << "0 common properties" << std::endl;
 
-        out << (runs[0]->metrics.size() + 2) << " properties for each run" << std::endl;  // run_properties
+        out << (types.size() + 2) << " properties for each run" << std::endl;  // run_properties
         out << "time REAL" << std::endl;
         out << "success BOOLEAN" << std::endl;
 
-        std::vector<std::reference_wrapper<const std::string>> keys;
-        for (const auto &metric : runs[0]->metrics)
+        for (const auto &type : types)
         {
             class ToString : public boost::static_visitor<const std::string>
             {
@@ -686,26 +897,29 @@ void OMPLPlanDataSetOutputter::dump(const PlanDataSet &results)
                 }
             };
 
-            const auto &name = metric.first;
-            keys.emplace_back(name);
-
-            out << name << " " << boost::apply_visitor(ToString(), metric.second) << std::endl;
+            out << type.first << " " << boost::apply_visitor(ToString(), type.second) << std::endl;
         }
 
         out << runs.size() << " runs" << std::endl;
 
+        // Metrics missing from a run are written as empty values.
         for (const auto &run : runs)
         {
             out << run->time << "; "  //
                 << run->success << "; ";
 
-            for (const auto &key : keys)
-                out << toMetricString(run->metrics.find(key)->second) << "; ";
+            for (const auto &type : types)
+            {
+                const auto &it = run->metrics.find(type.first);
+                if (it != run->metrics.end())
+                    out << toMetricString(it->second);
+
+                out << "; ";
+            }
 
             out << std::endl;
         }
 
-        const auto &progress_names = runs[0]->property_names;
         if (not progress_names.empty())
         {
             out << progress_names.size() << " progress properties for each run" << std::endl;
@@ -719,8 +933,11 @@ void OMPLPlanDataSetOutputter::dump(const PlanDataSet &results)
                 {
                     for (const auto &name : progress_names)
                     {
-                        auto it = point.find(name);
-                        out << it->second << ",";
+                        const auto &it = point.find(name);
+                        if (it != point.end())
+                            out << it->second;
+
+                        out << ",";
                     }
 
                     out << ";";
@@ -735,3 +952,543 @@ void OMPLPlanDataSetOutputter::dump(const PlanDataSet &results)
 
     out.close();
 }
+
+///
+/// PlanDataSetLoader
+///
+
+namespace
+{
+    /** Parse a metric from a JSON value written by JSONPlanDataSetOutputter. Quoted values are strings,
+     *  `true` and `false` are booleans, and numbers with a decimal point or exponent are doubles. */
+    PlannerMetric parseMetric(const YAML::Node &node)
+    {
+        const auto &value = node.as<std::string>();
+
+        // Quoted scalars have the non-specific tag `!`.
+        if (node.Tag() == "!")
+            return value;
+
+        if (value == "true" or value == "false")
+            return value == "true";
+
+        try
+        {
+            if (value.find_first_of(".eE") == std::string::npos)
+                return boost::lexical_cast<int>(value);
+        }
+        catch (boost::bad_lexical_cast &)
+        {
+        }
+
+        try
+        {
+            return boost::lexical_cast<double>(value);
+        }
+        catch (boost::bad_lexical_cast &)
+        {
+        }
+
+        return value;
+    }
+
+    /** Give each metric a single type across all runs of a dataset. Older files write integral doubles as
+     *  integers, so a metric that is a double in any run is made a double in all runs. */
+    void resolveMetricTypes(PlanDataSet &dataset)
+    {
+        std::set<std::string> doubles;
+        for (const auto &query : dataset.data)
+            for (const auto &run : query.second)
+                for (const auto &metric : run->metrics)
+                    if (boost::get<double>(&metric.second))
+                        doubles.emplace(metric.first);
+
+        for (const auto &query : dataset.data)
+            for (const auto &run : query.second)
+                for (auto &metric : run->metrics)
+                    if (doubles.find(metric.first) != doubles.end() and boost::get<int>(&metric.second))
+                        metric.second = toMetricDouble(metric.second);
+    }
+
+    /** Parse a metric of an OMPL benchmark log type from its string value. */
+    PlannerMetric parseMetric(const std::string &value, const std::string &type)
+    {
+        try
+        {
+            if (type == "BOOLEAN")
+                return boost::lexical_cast<int>(value) != 0;
+            if (type == "INT")
+                return boost::lexical_cast<int>(value);
+            if (type == "BIGINT")
+                return boost::lexical_cast<std::size_t>(value);
+            if (type == "REAL")
+                return boost::lexical_cast<double>(value);
+        }
+        catch (boost::bad_lexical_cast &)
+        {
+        }
+
+        return value;
+    }
+
+    /** Split a string on a delimiter, trimming whitespace and dropping empty trailing tokens. */
+    std::vector<std::string> splitLine(const std::string &line, char delimiter)
+    {
+        std::vector<std::string> tokens;
+        std::stringstream ss(line);
+        std::string token;
+        while (std::getline(ss, token, delimiter))
+        {
+            boost::algorithm::trim(token);
+            tokens.emplace_back(token);
+        }
+
+        while (not tokens.empty() and tokens.back().empty())
+            tokens.pop_back();
+
+        return tokens;
+    }
+
+    /** Read the leading count from a line like `5 runs`. */
+    bool readCount(std::istream &in, std::size_t &count, const std::string &suffix)
+    {
+        std::string line;
+        if (not std::getline(in, line) or line.find(suffix) == std::string::npos)
+            return false;
+
+        try
+        {
+            count = boost::lexical_cast<std::size_t>(line.substr(0, line.find(' ')));
+            return true;
+        }
+        catch (boost::bad_lexical_cast &)
+        {
+            return false;
+        }
+    }
+
+    /** Read a leading double from a line like `5.0 seconds per run`. */
+    double readDouble(const std::string &line)
+    {
+        try
+        {
+            return boost::lexical_cast<double>(line.substr(0, line.find(' ')));
+        }
+        catch (boost::bad_lexical_cast &)
+        {
+            return 0.;
+        }
+    }
+
+    PlanDataSetPtr makeDataSet(const std::string &name)
+    {
+        auto dataset = std::make_shared<PlanDataSet>();
+        dataset->name = name;
+        dataset->time = 0.;
+        dataset->allowed_time = 0.;
+        dataset->trials = 0;
+        dataset->enforced_single_thread = false;
+        dataset->run_till_timeout = false;
+        dataset->threads = 1;
+
+        return dataset;
+    }
+
+    /** Add a run to a dataset under a query, keeping query names unique. */
+    void addLoadedRun(PlanDataSet &dataset, const std::string &query, const PlanDataPtr &run)
+    {
+        auto &names = dataset.query_names;
+        if (std::find(names.begin(), names.end(), query) == names.end())
+            names.emplace_back(query);
+
+        dataset.addDataPoint(query, run);
+    }
+
+    /** Get the query name of a run name, by removing the `:<trial>:<index>[:<timeout trial>]` suffix added
+     *  by Experiment. */
+    std::string getQueryName(const std::string &name)
+    {
+        static const std::regex suffix("(:[0-9]+){2,3}$");
+        return std::regex_replace(name, suffix, "");
+    }
+
+    std::size_t countRuns(const PlanDataSet &dataset)
+    {
+        std::size_t runs = 0;
+        for (const auto &query : dataset.data)
+            runs += query.second.size();
+
+        return runs;
+    }
+
+    /** Merge the parameters of \a dataset into \a merged. Totals (time, trials, and queries) are only added
+     *  if \a totals is true, so they are not counted twice when a dataset is split over shards. */
+    void mergeParameters(PlanDataSet &merged, const PlanDataSet &dataset, bool totals)
+    {
+        if (totals)
+        {
+            merged.time += dataset.time;
+            merged.trials += dataset.trials;
+            merged.queries.insert(merged.queries.end(), dataset.queries.begin(), dataset.queries.end());
+        }
+
+        merged.allowed_time = std::max(merged.allowed_time, dataset.allowed_time);
+        merged.threads = std::max(merged.threads, dataset.threads);
+        merged.enforced_single_thread = merged.enforced_single_thread or dataset.enforced_single_thread;
+        merged.run_till_timeout = merged.run_till_timeout or dataset.run_till_timeout;
+
+        if (not dataset.start.is_not_a_date_time()
+            and (merged.start.is_not_a_date_time() or dataset.start < merged.start))
+            merged.start = dataset.start;
+
+        if (not dataset.finish.is_not_a_date_time()
+            and (merged.finish.is_not_a_date_time() or dataset.finish > merged.finish))
+            merged.finish = dataset.finish;
+    }
+
+    /** Merge the runs and parameters of \a dataset into \a merged. */
+    void mergeInto(PlanDataSet &merged, const PlanDataSet &dataset)
+    {
+        mergeParameters(merged, dataset, true);
+
+        // Use the dataset's query order, so output is stable.
+        for (const auto &query : dataset.query_names)
+        {
+            const auto &it = dataset.data.find(query);
+            if (it != dataset.data.end())
+                for (const auto &run : it->second)
+                    addLoadedRun(merged, query, run);
+        }
+    }
+}  // namespace
+
+std::vector<PlanDataSetPtr> PlanDataSetLoader::fromJSONFile(const std::string &file)
+{
+    std::vector<PlanDataSetPtr> datasets;
+
+    // JSON output is a subset of YAML, and can be read with the YAML parser.
+    const auto &yaml = IO::loadFileToYAML(file);
+    if (not yaml.first or not yaml.second.IsMap())
+    {
+        RBX_ERROR("Failed to load JSON benchmark file `%1%`", file);
+        return datasets;
+    }
+
+    try
+    {
+        for (const auto &entry : yaml.second)
+        {
+            auto dataset = makeDataSet(entry.first.as<std::string>());
+
+            for (const auto &node : entry.second)
+            {
+                auto run = std::make_shared<PlanData>();
+                run->time = 0.;
+                run->success = false;
+
+                for (const auto &field : node)
+                {
+                    const auto &key = field.first.as<std::string>();
+                    const auto &value = field.second.as<std::string>();
+
+                    if (key == "name")
+                        run->query.name = (value.compare(0, 4, "run_") == 0) ? value.substr(4) : value;
+                    else if (key == "time")
+                        run->time = boost::lexical_cast<double>(value);
+                    else if (key == "success")
+                        run->success = boost::lexical_cast<int>(value) != 0;
+                    else
+                        run->metrics[key] = parseMetric(field.second);
+                }
+
+                addLoadedRun(*dataset, getQueryName(run->query.name), run);
+            }
+
+            resolveMetricTypes(*dataset);
+
+            datasets.emplace_back(dataset);
+        }
+    }
+    catch (std::exception &e)
+    {
+        RBX_ERROR("Failed to parse JSON benchmark file `%1%`: %2%", file, e.what());
+        datasets.clear();
+    }
+
+    return datasets;
+}
+
+PlanDataSetPtr PlanDataSetLoader::fromOMPLLogFile(const std::string &file)
+{
+    std::ifstream in(IO::resolvePath(file));
+    if (not in)
+    {
+        RBX_ERROR("Failed to open OMPL benchmark log `%1%`", file);
+        return nullptr;
+    }
+
+    auto dataset = makeDataSet("");
+
+    // Header, up to the number of planners.
+    std::string line;
+    std::size_t num_queries = 0;
+    while (std::getline(in, line))
+    {
+        if (line.compare(0, 11, "Experiment ") == 0)
+            dataset->name = line.substr(11);
+        else if (line.compare(0, 12, "Starting at ") == 0)
+        {
+            try
+            {
+                dataset->start = boost::posix_time::time_from_string(line.substr(12));
+            }
+            catch (std::exception &)
+            {
+            }
+        }
+        else if (line.find(" seconds per run") != std::string::npos)
+            dataset->allowed_time = readDouble(line);
+        else if (line.find(" seconds spent to collect the data") != std::string::npos)
+            dataset->time = readDouble(line);
+        else if (line.find(" planners") != std::string::npos)
+        {
+            try
+            {
+                num_queries = boost::lexical_cast<std::size_t>(line.substr(0, line.find(' ')));
+            }
+            catch (boost::bad_lexical_cast &)
+            {
+                RBX_ERROR("Malformed planner count in OMPL benchmark log `%1%`", file);
+                return nullptr;
+            }
+
+            break;
+        }
+    }
+
+    for (std::size_t q = 0; q < num_queries; ++q)
+    {
+        std::string name;
+        std::size_t num_common, num_properties, num_runs;
+        if (not std::getline(in, name)                                         //
+            or not readCount(in, num_common, "common properties")              //
+            or num_common != 0                                                 //
+            or not readCount(in, num_properties, "properties for each run"))  //
+        {
+            RBX_ERROR("Malformed query header in OMPL benchmark log `%1%`", file);
+            return nullptr;
+        }
+
+        // Property names and types.
+        std::vector<std::pair<std::string, std::string>> properties;
+        for (std::size_t i = 0; i < num_properties and std::getline(in, line); ++i)
+        {
+            const auto &space = line.rfind(' ');
+            properties.emplace_back(line.substr(0, space), line.substr(space + 1));
+        }
+
+        if (properties.size() != num_properties or not readCount(in, num_runs, "runs"))
+        {
+            RBX_ERROR("Malformed properties in OMPL benchmark log `%1%`", file);
+            return nullptr;
+        }
+
+        std::vector<PlanDataPtr> runs;
+        for (std::size_t i = 0; i < num_runs and std::getline(in, line); ++i)
+        {
+            auto run = std::make_shared<PlanData>();
+            run->time = 0.;
+            run->success = false;
+
+            const auto &values = splitLine(line, ';');
+            for (std::size_t j = 0; j < std::min(values.size(), properties.size()); ++j)
+            {
+                const auto &property = properties[j];
+                if (property.first == "time")
+                    run->time = toMetricDouble(parseMetric(values[j], property.second));
+                else if (property.first == "success")
+                    run->success = toMetricDouble(parseMetric(values[j], property.second)) != 0.;
+                else if (not values[j].empty())
+                    run->metrics[property.first] = parseMetric(values[j], property.second);
+            }
+
+            runs.emplace_back(run);
+        }
+
+        // Optional progress properties, terminated by a single `.`.
+        while (std::getline(in, line) and line != ".")
+        {
+            if (line.find("progress properties for each run") == std::string::npos)
+                continue;
+
+            const auto &num_progress = boost::lexical_cast<std::size_t>(line.substr(0, line.find(' ')));
+
+            std::vector<std::string> progress_names;
+            for (std::size_t i = 0; i < num_progress and std::getline(in, line); ++i)
+                progress_names.emplace_back(line);
+
+            std::size_t num_progress_runs;
+            if (not readCount(in, num_progress_runs, "runs"))
+                break;
+
+            for (std::size_t i = 0; i < num_progress_runs and std::getline(in, line); ++i)
+            {
+                if (i >= runs.size())
+                    continue;
+
+                auto &run = runs[i];
+                run->property_names = progress_names;
+
+                for (const auto &point : splitLine(line, ';'))
+                {
+                    const auto &values = splitLine(point, ',');
+
+                    std::map<std::string, std::string> entry;
+                    for (std::size_t j = 0; j < std::min(values.size(), progress_names.size()); ++j)
+                        if (not values[j].empty())
+                            entry[progress_names[j]] = values[j];
+
+                    run->progress.emplace_back(entry);
+                }
+            }
+        }
+
+        for (const auto &run : runs)
+        {
+            run->query.name = name;
+            addLoadedRun(*dataset, name, run);
+        }
+    }
+
+    return dataset;
+}
+
+std::vector<PlanDataSetPtr> PlanDataSetLoader::fromFile(const std::string &file)
+{
+    if (boost::algorithm::ends_with(file, ".json"))
+        return fromJSONFile(file);
+
+    std::vector<PlanDataSetPtr> datasets;
+    auto dataset = fromOMPLLogFile(file);
+    if (dataset)
+        datasets.emplace_back(dataset);
+
+    return datasets;
+}
+
+std::vector<PlanDataSetPtr> PlanDataSetLoader::fromFiles(const std::vector<std::string> &files,
+                                                         unsigned int threads)
+{
+    Pool pool(std::max(1u, threads));
+
+    std::vector<std::shared_ptr<Pool::Job<std::vector<PlanDataSetPtr>>>> jobs;
+    for (const auto &file : files)
+        jobs.emplace_back(pool.submit(make_function([file] { return fromFile(file); })));
+
+    std::vector<PlanDataSetPtr> datasets;
+    for (const auto &job : jobs)
+    {
+        const auto &loaded = job->get();
+        datasets.insert(datasets.end(), loaded.begin(), loaded.end());
+    }
+
+    return datasets;
+}
+
+PlanDataSetPtr PlanDataSetLoader::merge(const std::vector<PlanDataSetPtr> &datasets, const std::string &name)
+{
+    auto merged = makeDataSet(name);
+    for (const auto &dataset : datasets)
+        mergeInto(*merged, *dataset);
+
+    return merged;
+}
+
+std::size_t PlanDataSetLoader::mergeFiles(const std::vector<std::string> &files, PlanDataSetOutputter &output,
+                                          std::size_t shard_size, unsigned int threads)
+{
+    threads = std::max(1u, threads);
+    Pool pool(threads);
+
+    // Current shard for each dataset name, and the number of shards dumped so far.
+    std::map<std::string, std::pair<PlanDataSetPtr, std::size_t>> shards;
+    std::size_t total = 0;
+
+    auto flush = [&](const std::string &name, std::pair<PlanDataSetPtr, std::size_t> &shard) {
+        if (not shard.first)
+            return;
+
+        if (shard_size > 0)
+            shard.first->name = log::format("%1%_shard%2%", name, shard.second);
+
+        const auto &runs = countRuns(*shard.first);
+        RBX_INFO("Writing `%1%` with %2% runs", shard.first->name, runs);
+
+        output.dump(*shard.first);
+        total += runs;
+
+        shard.first.reset();
+        shard.second++;
+    };
+
+    for (std::size_t i = 0; i < files.size(); i += threads)
+    {
+        // Load a batch of files in parallel.
+        std::vector<std::shared_ptr<Pool::Job<std::vector<PlanDataSetPtr>>>> jobs;
+        for (std::size_t j = i; j < std::min(files.size(), i + threads); ++j)
+        {
+            const auto &file = files[j];
+            jobs.emplace_back(pool.submit(make_function([file] { return fromFile(file); })));
+        }
+
+        for (const auto &job : jobs)
+            for (const auto &dataset : job->get())
+            {
+                auto &shard = shards[dataset->name];
+
+                // Add runs one at a time, so a shard is split within a dataset and never exceeds the size.
+                // The dataset's parameters are merged into each shard it adds runs to, with totals only once.
+                bool merged = false;
+                bool totals = true;
+                auto prepare = [&] {
+                    if (not shard.first)
+                        shard.first = makeDataSet(dataset->name);
+
+                    if (not merged)
+                    {
+                        mergeParameters(*shard.first, *dataset, totals);
+                        merged = true;
+                        totals = false;
+                    }
+                };
+
+                for (const auto &query : dataset->query_names)
+                {
+                    const auto &it = dataset->data.find(query);
+                    if (it == dataset->data.end())
+                        continue;
+
+                    for (const auto &run : it->second)
+                    {
+                        prepare();
+                        addLoadedRun(*shard.first, query, run);
+
+                        if (shard_size > 0 and countRuns(*shard.first) >= shard_size)
+                        {
+                            flush(dataset->name, shard);
+                            merged = false;
+                        }
+                    }
+                }
+
+                // Datasets without runs still contribute their parameters.
+                if (totals)
+                    prepare();
+            }
+    }
+
+    for (auto &shard : shards)
+        flush(shard.first, shard.second);
+
+    return total;
+}
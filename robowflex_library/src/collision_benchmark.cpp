@@ -0,0 +1,234 @@
+/* Author: Zachary Kingston */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include <random_numbers/random_numbers.h>
+
+#include <robowflex_library/collision_benchmark.h>
+#include <robowflex_library/io.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/robot.h>
+#include <robowflex_library/scene.h>
+#include <robowflex_library/trajectory.h>
+
+using namespace robowflex;
+
+///
+/// CollisionBenchmark::Result
+///
+
+double CollisionBenchmark::Result::getCheckRate() const
+{
+    return (check_time > 0.) ? states / check_time : 0.;
+}
+
+double CollisionBenchmark::Result::getDistanceRate() const
+{
+    return (distance_time > 0.) ? states / distance_time : 0.;
+}
+
+///
+/// CollisionBenchmark
+///
+
+CollisionBenchmark::CollisionBenchmark(const std::vector<std::string> &detectors) : detectors_(detectors)
+{
+}
+
+void CollisionBenchmark::addScene(const std::string &type, const std::string &name,
+                                  const SceneConstPtr &scene,
+                                  const std::vector<robot_state::RobotStatePtr> &states)
+{
+    entries_.push_back({type, name, scene, states});
+}
+
+void CollisionBenchmark::addScene(const std::string &type, const std::string &name,
+                                  const SceneConstPtr &scene, const Trajectory &trajectory)
+{
+    const auto &path = trajectory.getTrajectoryConst();
+
+    std::vector<robot_state::RobotStatePtr> states;
+    for (std::size_t i = 0; i < path->getWayPointCount(); ++i)
+    {
+        auto state = std::make_shared<robot_state::RobotState>(path->getWayPoint(i));
+        state->update(true);
+        states.emplace_back(state);
+    }
+
+    addScene(type, name, scene, states);
+}
+
+std::vector<robot_state::RobotStatePtr> CollisionBenchmark::sampleStates(const RobotConstPtr &robot,
+                                                                         const std::string &group,
+                                                                         std::size_t n, unsigned int seed)
+{
+    random_numbers::RandomNumberGenerator rng(seed);
+    const auto &jmg = robot->getModelConst()->getJointModelGroup(group);
+
+    std::vector<robot_state::RobotStatePtr> states;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto state = robot->allocState();
+        state->setToRandomPositions(jmg, rng);
+        state->update(true);
+        states.emplace_back(state);
+    }
+
+    return states;
+}
+
+std::vector<CollisionBenchmark::Result> CollisionBenchmark::run(bool distance) const
+{
+    std::vector<Result> results;
+    for (const auto &entry : entries_)
+    {
+        // Results from the first available detector, which all others are compared against.
+        bool have_reference = false;
+        std::vector<bool> reference_collisions;
+        std::vector<double> reference_distances;
+
+        for (const auto &detector : detectors_)
+        {
+            Result result;
+            result.type = entry.type;
+            result.scene = entry.name;
+            result.detector = detector;
+
+            // Each detector gets its own copy of the scene, so collision world caches are not shared.
+            auto scene = entry.scene->deepCopy();
+            result.available = scene->setCollisionDetector(detector)
+                               and scene->getSceneConst()->getActiveCollisionDetectorName() == detector;
+
+            if (not result.available)
+            {
+                results.emplace_back(result);
+                continue;
+            }
+
+            result.states = entry.states.size();
+
+            // Warm up any lazily initialized collision structures.
+            if (not entry.states.empty())
+            {
+                scene->checkCollision(*entry.states[0]);
+                if (distance)
+                    scene->distanceToCollision(*entry.states[0]);
+            }
+
+            std::vector<bool> collisions(entry.states.size());
+            auto start = IO::getDate();
+            for (std::size_t i = 0; i < entry.states.size(); ++i)
+                collisions[i] = scene->checkCollision(*entry.states[i]).collision;
+
+            result.check_time = IO::getSeconds(start, IO::getDate());
+
+            std::vector<double> distances;
+            if (distance)
+            {
+                distances.resize(entry.states.size());
+                start = IO::getDate();
+                for (std::size_t i = 0; i < entry.states.size(); ++i)
+                    distances[i] = scene->distanceToCollision(*entry.states[i]);
+
+                result.distance_time = IO::getSeconds(start, IO::getDate());
+            }
+
+            for (std::size_t i = 0; i < collisions.size(); ++i)
+            {
+                result.collisions += collisions[i];
+
+                if (have_reference)
+                {
+                    result.disagreements += collisions[i] != reference_collisions[i];
+
+                    // Distances are only comparable when both detectors report a finite distance.
+                    if (distance and std::isfinite(distances[i]) and std::isfinite(reference_distances[i]))
+                        result.max_distance_error = std::max(result.max_distance_error,
+                                                             std::abs(distances[i] - reference_distances[i]));
+                }
+            }
+
+            if (not have_reference)
+            {
+                have_reference = true;
+                reference_collisions = collisions;
+                reference_distances = distances;
+            }
+
+            RBX_INFO("%1% (%2%): %3%: %4% checks/s, %5% distances/s, %6% disagreements",  //
+                     entry.name, entry.type, detector, result.getCheckRate(), result.getDistanceRate(),
+                     result.disagreements);
+
+            results.emplace_back(result);
+        }
+    }
+
+    return results;
+}
+
+std::map<std::string, std::string> CollisionBenchmark::recommend(const std::vector<Result> &results)
+{
+    // Total states and check time for each detector over each scene type.
+    std::map<std::string, std::map<std::string, std::pair<std::size_t, double>>> totals;
+    std::map<std::string, std::map<std::string, bool>> agrees;
+
+    for (const auto &result : results)
+    {
+        if (not result.available)
+            continue;
+
+        auto &total = totals[result.type][result.detector];
+        total.first += result.states;
+        total.second += result.check_time;
+
+        auto it = agrees[result.type].emplace(result.detector, true).first;
+        it->second = it->second and result.disagreements == 0;
+    }
+
+    std::map<std::string, std::string> recommendations;
+    for (const auto &type : totals)
+    {
+        double best = -1.;
+        for (const auto &detector : type.second)
+        {
+            if (not agrees[type.first][detector.first])
+                continue;
+
+            const auto &total = detector.second;
+            const double rate = (total.second > 0.) ? total.first / total.second : 0.;
+            if (rate > best)
+            {
+                best = rate;
+                recommendations[type.first] = detector.first;
+            }
+        }
+
+        if (recommendations.find(type.first) != recommendations.end())
+            RBX_INFO("Recommended collision detector for `%1%` scenes: %2% (%3% checks/s)",  //
+                     type.first, recommendations[type.first], best);
+        else
+            RBX_WARN("No collision detector agreed with the reference for `%1%` scenes", type.first);
+    }
+
+    return recommendations;
+}
+
+void CollisionBenchmark::toCSVFile(const std::vector<Result> &results, const std::string &file)
+{
+    std::ofstream out;
+    IO::createFile(out, file);
+
+    out << "type,scene,detector,available,states,collisions,check_time,distance_time,check_rate,"
+           "distance_rate,disagreements,max_distance_error"
+        << std::endl;
+
+    for (const auto &result : results)
+        out << result.type << "," << result.scene << "," << result.detector << "," << result.available << ","
+            << result.states << "," << result.collisions << "," << result.check_time << ","
+            << result.distance_time << "," << result.getCheckRate() << "," << result.getDistanceRate() << ","
+            << result.disagreements << "," << result.max_distance_error << std::endl;
+
+    out.close();
+}
@@ -0,0 +1,180 @@
+/* Author: Zachary Kingston */
+
+#include <cmath>
+
+#include <robowflex_library/benchmarking.h>
+#include <robowflex_library/compare.h>
+#include <robowflex_library/log.h>
+
+using namespace robowflex;
+
+namespace
+{
+    /** Runs grouped by dataset, query, and planner. */
+    using RunMap = std::map<std::string, std::vector<PlanDataPtr>>;
+
+    RunMap groupRuns(const std::vector<PlanDataSetPtr> &datasets, const std::string &planner_metric)
+    {
+        RunMap runs;
+        for (const auto &dataset : datasets)
+            for (const auto &query : dataset->data)
+                for (const auto &run : query.second)
+                {
+                    auto key = dataset->name + "/" + query.first;
+
+                    auto it = run->metrics.find(planner_metric);
+                    if (it != run->metrics.end())
+                        key += " (" + toMetricString(it->second) + ")";
+
+                    runs[key].emplace_back(run);
+                }
+
+        return runs;
+    }
+
+    std::vector<double> getValues(const std::vector<PlanDataPtr> &runs, const std::string &metric)
+    {
+        std::vector<double> values;
+        for (const auto &run : runs)
+        {
+            if (metric == "time")
+                values.emplace_back(run->time);
+            else if (run->success)
+            {
+                auto it = run->metrics.find(metric);
+                if (it == run->metrics.end())
+                    continue;
+
+                const double value = toMetricDouble(it->second);
+                if (std::isfinite(value))
+                    values.emplace_back(value);
+            }
+        }
+
+        return values;
+    }
+}  // namespace
+
+PlanDataSetComparator::PlanDataSetComparator() : PlanDataSetComparator(Options())
+{
+}
+
+PlanDataSetComparator::PlanDataSetComparator(const Options &options) : options_(options)
+{
+}
+
+PlanDataSetComparator::Options &PlanDataSetComparator::getOptions()
+{
+    return options_;
+}
+
+std::vector<PlanDataSetComparator::Comparison>
+PlanDataSetComparator::compare(const std::vector<PlanDataSetPtr> &baseline,
+                               const std::vector<PlanDataSetPtr> &candidate) const
+{
+    const auto &baseline_runs = groupRuns(baseline, options_.planner_metric);
+    const auto &candidate_runs = groupRuns(candidate, options_.planner_metric);
+
+    // Compare a metric by medians. Time is compared as if smaller values are better.
+    auto compareMetric = [&](const std::string &key, const std::vector<PlanDataPtr> &a,
+                             const std::vector<PlanDataPtr> &b, const std::string &metric,
+                             bool higher_is_better, double threshold) {
+        const auto &va = getValues(a, metric);
+        const auto &vb = getValues(b, metric);
+
+        Comparison comparison;
+        comparison.key = key;
+        comparison.metric = metric;
+        comparison.baseline_n = va.size();
+        comparison.candidate_n = vb.size();
+        comparison.test = stats::mannWhitneyU(vb, va);
+        comparison.significant = comparison.test.p < options_.alpha;
+
+        if (not va.empty() and not vb.empty())
+        {
+            comparison.baseline = stats::quantile(va, 0.5);
+            comparison.candidate = stats::quantile(vb, 0.5);
+
+            const double difference = comparison.candidate - comparison.baseline;
+            comparison.change = (comparison.baseline != 0.) ? difference / std::abs(comparison.baseline) : 0.;
+
+            const double worse = (higher_is_better) ? -comparison.change : comparison.change;
+            comparison.regression = comparison.significant and worse > threshold;
+        }
+
+        return comparison;
+    };
+
+    std::vector<Comparison> comparisons;
+    for (const auto &entry : baseline_runs)
+    {
+        const auto &key = entry.first;
+        const auto &it = candidate_runs.find(key);
+        if (it == candidate_runs.end())
+        {
+            RBX_WARN("Baseline `%1%` has no matching candidate runs", key);
+            continue;
+        }
+
+        const auto &a = entry.second;
+        const auto &b = it->second;
+
+        comparisons.emplace_back(compareMetric(key, a, b, "time", false, options_.time_threshold));
+
+        std::size_t sa = 0, sb = 0;
+        for (const auto &run : a)
+            sa += run->success;
+        for (const auto &run : b)
+            sb += run->success;
+
+        Comparison success;
+        success.key = key;
+        success.metric = "success";
+        success.baseline_n = a.size();
+        success.candidate_n = b.size();
+        success.baseline = double(sa) / a.size();
+        success.candidate = double(sb) / b.size();
+        success.change = success.candidate - success.baseline;
+        success.test = stats::proportionTest(sb, b.size(), sa, a.size());
+        success.significant = success.test.p < options_.alpha;
+        success.regression = success.significant and -success.change > options_.success_threshold;
+        comparisons.emplace_back(success);
+
+        for (const auto &metric : options_.metrics)
+            comparisons.emplace_back(
+                compareMetric(key, a, b, metric.first, metric.second, options_.metric_threshold));
+    }
+
+    for (const auto &entry : candidate_runs)
+        if (baseline_runs.find(entry.first) == baseline_runs.end())
+            RBX_WARN("Candidate `%1%` has no matching baseline runs", entry.first);
+
+    return comparisons;
+}
+
+bool PlanDataSetComparator::hasRegression(const std::vector<Comparison> &comparisons)
+{
+    for (const auto &comparison : comparisons)
+        if (comparison.regression)
+            return true;
+
+    return false;
+}
+
+void PlanDataSetComparator::report(const std::vector<Comparison> &comparisons)
+{
+    for (const auto &c : comparisons)
+    {
+        const auto &message =
+            log::format("%1% %2%: %3% -> %4% (%5$+.1f%%), n = %6%/%7%, p = %8$.4f, effect = %9$+.3f",  //
+                        c.key, c.metric, c.baseline, c.candidate, c.change * 100.,  //
+                        c.baseline_n, c.candidate_n, c.test.p, c.test.effect);
+
+        if (c.regression)
+            RBX_ERROR("REGRESSION %1%", message);
+        else if (c.significant)
+            RBX_WARN("CHANGED %1%", message);
+        else
+            RBX_INFO("%1%", message);
+    }
+}
@@ -0,0 +1,191 @@
+/* Author: Zachary Kingston */
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+#include <boost/filesystem.hpp>
+
+#include <robowflex_library/builder.h>
+#include <robowflex_library/dataset.h>
+#include <robowflex_library/io.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/robot.h>
+#include <robowflex_library/scene.h>
+
+using namespace robowflex;
+
+namespace
+{
+    /** Get the key files are paired by, the number at the end of a file name, or the rest of the name after
+     * the prefix if there is no number. */
+    std::string getPairKey(const std::string &stem, const std::string &prefix)
+    {
+        auto it = stem.end();
+        while (it != stem.begin() and std::isdigit(*(it - 1)))
+            --it;
+
+        if (it != stem.end())
+            return std::string(it, stem.end());
+
+        return stem.substr(prefix.size());
+    }
+}  // namespace
+
+///
+/// DatasetLoader
+///
+
+DatasetLoader::DatasetLoader(const RobotPtr &robot, const PlannerPtr &planner, const std::string &group,
+                             std::size_t threads, std::size_t prefetch)
+  : robot_(robot)
+  , planner_(planner)
+  , group_(group)
+  , prefetch_(std::max<std::size_t>(prefetch, 1))
+  , pool_(std::max<std::size_t>(threads, 1))
+{
+}
+
+void DatasetLoader::addEntry(const std::string &name, const std::string &scene_file,
+                             const std::string &request_file)
+{
+    entries_.push_back({name, scene_file, request_file});
+}
+
+std::size_t DatasetLoader::addDirectory(const std::string &directory,     //
+                                        const std::string &scene_prefix,  //
+                                        const std::string &request_prefix)
+{
+    const auto &contents = IO::listDirectory(directory);
+    if (not contents.first)
+    {
+        RBX_ERROR("Failed to list directory `%1%`", directory);
+        return 0;
+    }
+
+    std::map<std::string, std::pair<std::string, std::string>> scenes;
+    std::map<std::string, std::string> requests;
+    for (const auto &file : contents.second)
+    {
+        const boost::filesystem::path path(file);
+        const auto &extension = path.extension().string();
+        if (extension != ".yaml" and extension != ".yml")
+            continue;
+
+        // Check requests first, in case one prefix is a prefix of the other.
+        const auto &stem = path.stem().string();
+        if (stem.compare(0, request_prefix.size(), request_prefix) == 0)
+            requests.emplace(getPairKey(stem, request_prefix), file);
+        else if (stem.compare(0, scene_prefix.size(), scene_prefix) == 0)
+            scenes.emplace(getPairKey(stem, scene_prefix), std::make_pair(stem, file));
+    }
+
+    std::size_t added = 0;
+    for (const auto &scene : scenes)
+    {
+        const auto &request = requests.find(scene.first);
+        if (request == requests.end())
+        {
+            RBX_WARN("No request for scene `%1%`", scene.second.second);
+            continue;
+        }
+
+        addEntry(scene.second.first, scene.second.second, request->second);
+        added++;
+    }
+
+    return added;
+}
+
+const std::vector<DatasetLoader::Entry> &DatasetLoader::getEntries() const
+{
+    return entries_;
+}
+
+void DatasetLoader::setItemCallback(const ItemCallback &callback)
+{
+    callback_ = callback;
+}
+
+bool DatasetLoader::next(Item &item)
+{
+    while (true)
+    {
+        // Keep the prefetch window full.
+        while (jobs_.size() < prefetch_ and index_ < entries_.size())
+        {
+            const auto &entry = entries_[index_++];
+            jobs_.emplace_back(pool_.submit(make_function([this, entry] { return load(entry); })));
+        }
+
+        if (jobs_.empty())
+            return false;
+
+        const auto job = jobs_.front();
+        jobs_.pop_front();
+
+        const auto &loaded = job->get();
+        if (loaded)
+        {
+            item = *loaded;
+            return true;
+        }
+    }
+}
+
+std::size_t DatasetLoader::benchmark(Experiment &experiment, PlanDataSetOutputter &output,
+                                     std::size_t n_threads)
+{
+    std::size_t benchmarked = 0;
+
+    Item item;
+    while (next(item))
+    {
+        experiment.clearQueries();
+        experiment.addQuery(item.name, item.scene, planner_, item.request);
+
+        auto dataset = experiment.benchmark(n_threads);
+        dataset->name = log::format("%1%_%2%", dataset->name, item.name);
+        output.dump(*dataset);
+
+        benchmarked++;
+    }
+
+    experiment.clearQueries();
+    return benchmarked;
+}
+
+std::shared_ptr<DatasetLoader::Item> DatasetLoader::load(const Entry &entry) const
+{
+    auto item = std::make_shared<Item>();
+    item->name = entry.name;
+
+    item->scene = std::make_shared<Scene>(robot_);
+    if (not item->scene->fromYAMLFile(entry.scene_file))
+    {
+        RBX_ERROR("Failed to read file: %1% for scene", entry.scene_file);
+        return nullptr;
+    }
+
+    item->request = std::make_shared<MotionRequestBuilder>(planner_, group_);
+    if (not item->request->fromYAMLFile(entry.request_file))
+    {
+        RBX_ERROR("Failed to read file: %1% for request", entry.request_file);
+        return nullptr;
+    }
+
+    const auto &group = item->request->getRequestConst().group_name;
+    if (not robot_->getModelConst()->hasJointModelGroup(group))
+    {
+        RBX_ERROR("Request %1% is for group `%2%`, which is not in the robot", entry.request_file, group);
+        return nullptr;
+    }
+
+    if (callback_ and not callback_(*item))
+    {
+        RBX_WARN("Skipping `%1%`, rejected by callback", entry.name);
+        return nullptr;
+    }
+
+    return item;
+}
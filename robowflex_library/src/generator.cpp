@@ -0,0 +1,206 @@
+/* Author: Zachary Kingston */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <random_numbers/random_numbers.h>
+
+#include <robowflex_library/builder.h>
+#include <robowflex_library/generator.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/pool.h>
+#include <robowflex_library/robot.h>
+#include <robowflex_library/scene.h>
+#include <robowflex_library/tf.h>
+
+using namespace robowflex;
+
+namespace
+{
+    Eigen::Vector3d sampleBox(random_numbers::RandomNumberGenerator &rng, const Eigen::Vector3d &lower,
+                              const Eigen::Vector3d &upper)
+    {
+        return {rng.uniformReal(lower[0], upper[0]),  //
+                rng.uniformReal(lower[1], upper[1]),  //
+                rng.uniformReal(lower[2], upper[2])};
+    }
+
+    bool isInside(const Eigen::Vector3d &point, const Eigen::Vector3d &lower, const Eigen::Vector3d &upper)
+    {
+        return (point.array() >= lower.array()).all() and (point.array() <= upper.array()).all();
+    }
+}  // namespace
+
+SceneGenerator::SceneGenerator(const RobotConstPtr &robot, const std::string &group)
+  : SceneGenerator(robot, group, Options())
+{
+}
+
+SceneGenerator::SceneGenerator(const RobotConstPtr &robot, const std::string &group, const Options &options)
+  : robot_(robot), group_(group), options_(options)
+{
+}
+
+SceneGenerator::Options &SceneGenerator::getOptions()
+{
+    return options_;
+}
+
+bool SceneGenerator::generate(unsigned int seed, const ScenePtr &scene, MotionRequestBuilder &request) const
+{
+    random_numbers::RandomNumberGenerator rng(seed);
+    const auto &jmg = robot_->getModelConst()->getJointModelGroup(group_);
+
+    auto start = robot_->allocState();
+    auto goal = robot_->allocState();
+
+    // Sample a start and goal that are valid in the empty scene. Obstacles are then only placed if they
+    // keep both valid, so the pair is guaranteed valid in the final scene.
+    auto sample = [&](robot_state::RobotState &state, bool is_goal) {
+        for (std::size_t i = 0; i < options_.attempts; ++i)
+        {
+            state.setToRandomPositions(jmg, rng);
+            state.update(true);
+
+            if (scene->checkCollision(state).collision)
+                continue;
+
+            if (is_goal and not options_.tip.empty()
+                and not isInside(state.getGlobalLinkTransform(options_.tip).translation(),  //
+                                 options_.lower, options_.upper))
+                continue;
+
+            return true;
+        }
+
+        return false;
+    };
+
+    if (not sample(*start, false) or not sample(*goal, true))
+    {
+        RBX_ERROR("Failed to sample valid start and goal for seed %1%", seed);
+        return false;
+    }
+
+    addObstacles(rng.uniformInteger(0, std::numeric_limits<int>::max()), scene, {start, goal});
+
+    request.setStartConfiguration(start);
+    request.setGoalConfiguration(goal);
+
+    return true;
+}
+
+std::size_t SceneGenerator::addObstacles(unsigned int seed, const ScenePtr &scene,
+                                         const std::vector<robot_state::RobotStatePtr> &states) const
+{
+    random_numbers::RandomNumberGenerator rng(seed);
+
+    std::size_t n = options_.obstacles;
+    if (options_.density > 0.)
+        n = std::lround(options_.density * (options_.upper - options_.lower).prod());
+
+    std::vector<Geometry::ShapeType::Type> shapes;
+    for (const auto &shape : options_.shapes)
+        if (shape != Geometry::ShapeType::MESH or not options_.meshes.empty())
+            shapes.emplace_back(shape);
+
+    if (shapes.empty())
+    {
+        RBX_ERROR("No shapes available to generate obstacles from!");
+        return 0;
+    }
+
+    auto valid = [&](const robot_state::RobotState &state) {
+        if (options_.clearance > 0.)
+            return scene->distanceToCollision(state) >= options_.clearance;
+
+        return not scene->checkCollision(state).collision;
+    };
+
+    const auto &existing = scene->getCollisionObjects();
+
+    std::size_t added = 0;
+    std::size_t index = 0;
+    for (std::size_t i = 0; added < n and i < options_.attempts * n; ++i)
+    {
+        std::string name;
+        do
+            name = log::format("obstacle%1%", index++);
+        while (std::find(existing.begin(), existing.end(), name) != existing.end());
+
+        const auto &size = sampleBox(rng, options_.min_size, options_.max_size);
+        const auto &position = sampleBox(rng, options_.lower, options_.upper);
+
+        double q[4];
+        rng.quaternion(q);
+        const Eigen::Quaterniond rotation(q[3], q[0], q[1], q[2]);
+
+        GeometryPtr geometry;
+        switch (shapes[rng.uniformInteger(0, shapes.size() - 1)])
+        {
+            case Geometry::ShapeType::SPHERE:
+                geometry = Geometry::makeSphere(size[0] / 2.);
+                break;
+            case Geometry::ShapeType::CYLINDER:
+                geometry = Geometry::makeCylinder(size[0] / 2., size[2]);
+                break;
+            case Geometry::ShapeType::CONE:
+                geometry = Geometry::makeCone(size[0] / 2., size[2]);
+                break;
+            case Geometry::ShapeType::MESH:
+                geometry = Geometry::makeMesh(
+                    options_.meshes[rng.uniformInteger(0, options_.meshes.size() - 1)], size);
+                break;
+            case Geometry::ShapeType::BOX:
+            default:
+                geometry = Geometry::makeBox(size);
+                break;
+        }
+
+        scene->updateCollisionObject(name, geometry, TF::createPoseQ(position, rotation));
+
+        if (std::all_of(states.begin(), states.end(), [&](const robot_state::RobotStatePtr &state) {
+                return valid(*state);
+            }))
+            added++;
+        else
+        {
+            scene->removeCollisionObject(name);
+            index--;
+        }
+    }
+
+    if (added < n)
+        RBX_WARN("Only placed %1% of %2% obstacles", added, n);
+
+    return added;
+}
+
+std::size_t SceneGenerator::generateToDirectory(const std::string &directory, std::size_t count,
+                                                unsigned int seed, unsigned int threads) const
+{
+    Pool pool(std::max(1u, threads));
+
+    std::vector<std::shared_ptr<Pool::Job<bool>>> jobs;
+    for (std::size_t i = 1; i <= count; ++i)
+        jobs.emplace_back(pool.submit(make_function([this, i, seed, directory] {
+            auto scene = std::make_shared<Scene>(robot_);
+            MotionRequestBuilder request(robot_, group_);
+
+            if (not generate(seed + i, scene, request))
+                return false;
+
+            const auto &scene_file = log::format("%1%/scene%2$04d.yaml", directory, i);
+            const auto &request_file = log::format("%1%/request%2$04d.yaml", directory, i);
+
+            return scene->toYAMLFile(scene_file) and request.toYAMLFile(request_file);
+        })));
+
+    std::size_t written = 0;
+    for (const auto &job : jobs)
+        written += job->get();
+
+    RBX_INFO("Generated %1% of %2% scenes and requests in `%3%`", written, count, directory);
+    return written;
+}
@@ -1,13 +1,111 @@
 /* Author: Zachary Kingston, Constantinos Chamzas */
 
+#include <boost/filesystem.hpp>  // for last_write_time
+
 #include <geometric_shapes/shape_operations.h>
 
 #include <robowflex_library/geometry.h>
 #include <robowflex_library/io.h>
+#include <robowflex_library/log.h>
 #include <robowflex_library/util.h>
 
 using namespace robowflex;
 
+namespace
+{
+    /** Random number generator for each thread, seeded once from system entropy. */
+    random_numbers::RandomNumberGenerator &getThreadRNG()
+    {
+        static thread_local random_numbers::RandomNumberGenerator rng;
+        return rng;
+    }
+}  // namespace
+
+///
+/// MeshCache
+///
+
+MeshCache &MeshCache::getInstance()
+{
+    static MeshCache instance;
+    return instance;
+}
+
+MeshCache::Entry MeshCache::load(const std::string &resource, const Eigen::Vector3d &scale)
+{
+    boost::system::error_code ec;
+    const std::time_t mtime = boost::filesystem::last_write_time(resource, ec);
+
+    const Key key{resource, scale[0], scale[1], scale[2]};
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto &it = entries_.find(key);
+        if (it != entries_.end() and it->second.mtime == mtime)
+        {
+            stats_.hits++;
+            return it->second;
+        }
+
+        stats_.misses++;
+    }
+
+    // Load outside of the lock, so other meshes can be loaded concurrently.
+    Entry entry;
+    entry.resource = resource;
+    entry.scale = scale;
+    entry.mtime = mtime;
+    entry.shape.reset(shapes::createMeshFromResource("file://" + resource, scale));
+
+    if (not entry.shape)
+    {
+        RBX_ERROR("Failed to load mesh `%1%`", resource);
+        return entry;
+    }
+
+    entry.body = std::make_shared<bodies::ConvexMesh>(entry.shape.get());
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto &cached = entries_[key];
+
+    // Another thread may have loaded the same mesh in the meantime.
+    if (cached.shape and cached.mtime == mtime)
+        return cached;
+
+    cached = entry;
+    stats_.entries = entries_.size();
+    return entry;
+}
+
+bool MeshCache::find(const shapes::Shape *shape, Entry &entry) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (const auto &cached : entries_)
+        if (cached.second.shape.get() == shape)
+        {
+            entry = cached.second;
+            return true;
+        }
+
+    return false;
+}
+
+MeshCache::Stats MeshCache::getStats() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MeshCache::clear()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    entries_.clear();
+    stats_ = Stats();
+}
+
+///
+/// Geometry
+///
+
 const unsigned int Geometry::ShapeType::MAX = (unsigned int)Geometry::ShapeType::MESH + 1;
 const std::vector<std::string> Geometry::ShapeType::STRINGS({"box", "sphere", "cylinder", "cone", "mesh"});
 
@@ -104,9 +202,14 @@ Geometry::Geometry(ShapeType::Type type, const Eigen::Vector3d &dimensions, cons
   , dimensions_(dimensions)
   , vertices_(vertices)
   , resource_((resource.empty()) ? "" : IO::resolvePath(resource))
-  , shape_(loadShape())
-  , body_(loadBody())
 {
+    if (type_ == ShapeType::MESH and not resource_.empty() and vertices_.empty())
+        useCachedMesh(MeshCache::getInstance().load(resource_, dimensions_));
+    else
+    {
+        shape_.reset(loadShape());
+        body_.reset(loadBody());
+    }
 }
 
 Geometry::Geometry(const shapes::Shape &shape)
@@ -148,6 +251,17 @@ Geometry::Geometry(const shapes::Shape &shape)
         case shapes::ShapeType::MESH:
         {
             type_ = ShapeType::MESH;
+
+            // Share the mesh if it was loaded through the cache, e.g., if it was added to a scene.
+            MeshCache::Entry entry;
+            if (MeshCache::getInstance().find(&shape, entry))
+            {
+                resource_ = entry.resource;
+                dimensions_ = entry.scale;
+                useCachedMesh(entry);
+                return;
+            }
+
             const auto &mesh = static_cast<const shapes::Mesh &>(shape);
             shape_.reset(mesh.clone());
             break;
@@ -204,6 +318,15 @@ shapes::Shape *Geometry::loadShape() const
     return nullptr;
 }
 
+void Geometry::useCachedMesh(const MeshCache::Entry &entry)
+{
+    shape_ = entry.shape;
+
+    // Cloned convex meshes share their hull, so this is cheap and gives each geometry its own pose.
+    if (entry.body)
+        body_ = entry.body->cloneAt(entry.body->getPose());
+}
+
 bodies::Body *Geometry::loadBody() const
 {
     switch (type_)
@@ -237,17 +360,155 @@ bool Geometry::contains(const Eigen::Vector3d &point) const
     return body_->containsPoint(point[0], point[1], point[2]);
 }
 
+std::size_t Geometry::contains(const Eigen::Matrix3Xd &points, ContainsMask &mask) const
+{
+    mask.setConstant(points.cols(), false);
+    if (not body_)
+    {
+        RBX_ERROR("Geometry of type %1% does not support point containment", ShapeType::toString(type_));
+        return 0;
+    }
+
+    Eigen::Vector3d half;
+    if (getPrimitiveExtents(half))
+        mask = containsPrimitive(body_->getPose().inverse() * points, half);
+    else
+    {
+        bodies::BoundingSphere sphere;
+        body_->computeBoundingSphere(sphere);
+
+        const auto &culled = ((points.colwise() - sphere.center).colwise().squaredNorm().array()  //
+                              <= sphere.radius * sphere.radius)
+                                 .transpose()
+                                 .eval();
+
+        for (Eigen::Index i = 0; i < points.cols(); ++i)
+            mask[i] = culled[i] and body_->containsPoint(points.col(i));
+    }
+
+    return mask.count();
+}
+
 std::pair<bool, Eigen::Vector3d> Geometry::sample(const unsigned int attempts) const
+{
+    return sample(getThreadRNG(), attempts);
+}
+
+std::pair<bool, Eigen::Vector3d> Geometry::sample(random_numbers::RandomNumberGenerator &rng,
+                                                  const unsigned int attempts) const
 {
     bool success;
     Eigen::Vector3d point;
-    random_numbers::RandomNumberGenerator rng;
 
     if (!(success = body_->samplePointInside(rng, attempts, point)))
         point = Eigen::Vector3d{0, 0, 0};
 
     return std::make_pair(success, point);
 }
+
+std::size_t Geometry::sample(std::size_t n, Eigen::Matrix3Xd &points,
+                             random_numbers::RandomNumberGenerator &rng, const unsigned int attempts) const
+{
+    points.resize(3, n);
+    if (not body_)
+    {
+        RBX_ERROR("Geometry of type %1% does not support sampling", ShapeType::toString(type_));
+        points.resize(3, 0);
+        return 0;
+    }
+
+    std::size_t count = 0;
+
+    Eigen::Vector3d half;
+    if (getPrimitiveExtents(half))
+    {
+        // Rejection sample from the bounding box in batches, which are at least half accepted for all
+        // primitives.
+        std::size_t budget = n * attempts;
+        Eigen::Matrix3Xd candidates;
+        while (count < n and budget > 0)
+        {
+            const std::size_t m = std::min(budget, 2 * (n - count));
+            budget -= m;
+
+            candidates.resize(3, m);
+            for (std::size_t i = 0; i < m; ++i)
+                for (std::size_t j = 0; j < 3; ++j)
+                    candidates(j, i) = rng.uniformReal(-half[j], half[j]);
+
+            const auto &mask = containsPrimitive(candidates, half);
+            for (std::size_t i = 0; i < m and count < n; ++i)
+                if (mask[i])
+                    points.col(count++) = candidates.col(i);
+        }
+
+        points.leftCols(count) = body_->getPose() * points.leftCols(count);
+    }
+    else
+    {
+        Eigen::Vector3d point;
+        for (std::size_t i = 0; i < n; ++i)
+            if (body_->samplePointInside(rng, attempts, point))
+                points.col(count++) = point;
+    }
+
+    points.conservativeResize(3, count);
+    return count;
+}
+
+std::size_t Geometry::sample(std::size_t n, Eigen::Matrix3Xd &points, const unsigned int attempts) const
+{
+    return sample(n, points, getThreadRNG(), attempts);
+}
+
+bool Geometry::getPrimitiveExtents(Eigen::Vector3d &half) const
+{
+    const double scale = body_->getScale();
+    const double padding = body_->getPadding();
+
+    switch (type_)
+    {
+        case ShapeType::BOX:
+            half = dimensions_ * scale / 2. + Eigen::Vector3d::Constant(padding);
+            return true;
+
+        case ShapeType::SPHERE:
+            half = Eigen::Vector3d::Constant(dimensions_[0] * scale + padding);
+            return true;
+
+        case ShapeType::CYLINDER:
+        {
+            const double radius = dimensions_[0] * scale + padding;
+            half = Eigen::Vector3d{radius, radius, dimensions_[1] * scale / 2. + padding};
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+Geometry::ContainsMask Geometry::containsPrimitive(const Eigen::Matrix3Xd &local,
+                                                   const Eigen::Vector3d &half) const
+{
+    switch (type_)
+    {
+        case ShapeType::BOX:
+            return ((local.array().abs().colwise() - half.array()) <= 0.).colwise().all().transpose();
+
+        case ShapeType::SPHERE:
+            return (local.colwise().squaredNorm().array() <= half[0] * half[0]).transpose();
+
+        case ShapeType::CYLINDER:
+            return ((local.topRows<2>().colwise().squaredNorm().array() <= half[0] * half[0])  //
+                    and (local.row(2).array().abs() <= half[2]))
+                .transpose();
+
+        default:
+            return ContainsMask::Constant(local.cols(), false);
+    }
+}
+
 bool Geometry::isMesh() const
 {
     return type_ == ShapeType::MESH;
@@ -402,9 +402,135 @@ IO::Bag::Bag(const std::string &file, Mode mode)
 {
 }
 
+IO::Bag::Bag(const std::string &file, const WriterOptions &options)
+  : mode_(WRITE), file_(file), bag_(file_, rosbag::bagmode::Write), options_(options)
+{
+    bag_.setChunkThreshold(options_.chunk_size);
+    bag_.setCompression(options_.compression);
+
+    thread_ = std::thread([this] { run(); });
+}
+
 IO::Bag::~Bag()
 {
-    bag_.close();
+    if (thread_.joinable())
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_ = true;
+        }
+
+        cv_.notify_all();
+        thread_.join();
+
+        if (stats_.dropped)
+            RBX_WARN("Dropped %1% of %2% messages written to `%3%`",  //
+                     stats_.dropped, stats_.dropped + stats_.written, file_);
+
+        if (stats_.failed)
+            RBX_WARN("Failed to write %1% messages to `%2%`", stats_.failed, file_);
+    }
+
+    try
+    {
+        bag_.close();
+    }
+    catch (rosbag::BagException &e)
+    {
+        RBX_ERROR("Failed to close bag `%1%`: %2%", file_, e.what());
+    }
+}
+
+void IO::Bag::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return queue_.empty() and active_ == 0; });
+}
+
+IO::Bag::WriterStats IO::Bag::getWriterStats() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool IO::Bag::enqueue(std::function<void()> &&write)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (queue_.size() >= options_.queue_size and not failed_)
+    {
+        if (not options_.block)
+        {
+            stats_.dropped++;
+            return false;
+        }
+
+        stats_.backpressured++;
+        cv_.wait(lock, [&] { return queue_.size() < options_.queue_size or failed_; });
+    }
+
+    if (failed_)
+    {
+        stats_.failed++;
+        return false;
+    }
+
+    queue_.emplace_back(std::move(write));
+    cv_.notify_all();
+    return true;
+}
+
+void IO::Bag::run()
+{
+    std::deque<std::function<void()>> batch;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        cv_.wait(lock, [&] { return not queue_.empty() or done_; });
+        if (queue_.empty())
+            break;
+
+        // Take all queued writes at once, so producers only contend for the lock once per batch.
+        batch.swap(queue_);
+        active_ = batch.size();
+        cv_.notify_all();
+
+        lock.unlock();
+
+        // Catch write errors, as an exception on this thread would terminate the process.
+        std::size_t written = 0;
+        try
+        {
+            for (const auto &write : batch)
+            {
+                write();
+                written++;
+            }
+        }
+        catch (rosbag::BagException &e)
+        {
+            RBX_ERROR("Failed to write to bag `%1%`, stopping writing: %2%", file_, e.what());
+        }
+
+        lock.lock();
+        stats_.written += written;
+
+        // Stop writing on failure, counting all messages not written.
+        if (written != batch.size())
+        {
+            failed_ = true;
+            stats_.failed += batch.size() - written + queue_.size();
+            queue_.clear();
+        }
+
+        active_ = 0;
+        batch.clear();
+
+        cv_.notify_all();
+
+        if (failed_)
+            break;
+    }
 }
 
 ///
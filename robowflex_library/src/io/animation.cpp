@@ -0,0 +1,281 @@
+/* Author: Zachary Kingston */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <robowflex_library/io.h>
+#include <robowflex_library/io/animation.h>
+#include <robowflex_library/io/yaml.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/tf.h>
+
+using namespace robowflex;
+
+namespace
+{
+    const char MAGIC[] = "RBXANIM1";  // Header of animation files.
+    const std::size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+    const std::size_t STRIDE = 7;  // Values per link, position then orientation.
+
+    const uint8_t KEYFRAME = 0;  // Frame with the pose of every link.
+    const uint8_t DELTA = 1;     // Frame with the poses of links that moved.
+
+    template <typename T>
+    void writeValue(std::ofstream &out, const T &value)
+    {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream &in, T &value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+    }
+}  // namespace
+
+///
+/// IO::AnimationWriter
+///
+
+IO::AnimationWriter::AnimationWriter(const std::string &filename, const std::vector<std::string> &links,
+                                     double fps, std::size_t keyframe_interval, double tolerance)
+  : links_(links.size())
+  , keyframe_interval_(keyframe_interval)
+  , tolerance_(tolerance)
+  , previous_(links_ * STRIDE)
+  , current_(links_ * STRIDE)
+  , mask_((links_ + 7) / 8)
+{
+    IO::createFile(out_, filename);
+    if (not out_)
+    {
+        RBX_ERROR("Failed to open `%1%` for writing", filename);
+        return;
+    }
+
+    out_.write(MAGIC, MAGIC_SIZE);
+    writeValue(out_, fps);
+    writeValue(out_, static_cast<uint32_t>(keyframe_interval_));
+    writeValue(out_, static_cast<uint32_t>(links_));
+
+    for (const auto &link : links)
+    {
+        writeValue(out_, static_cast<uint32_t>(link.size()));
+        out_.write(link.data(), link.size());
+    }
+}
+
+IO::AnimationWriter::~AnimationWriter()
+{
+    close();
+}
+
+bool IO::AnimationWriter::isOpen() const
+{
+    return out_.is_open() and out_.good();
+}
+
+bool IO::AnimationWriter::addFrame(double duration, const RobotPoseVector &poses)
+{
+    if (not isOpen())
+        return false;
+
+    if (poses.size() != links_)
+    {
+        RBX_ERROR("Frame has %1% poses, expected %2%", poses.size(), links_);
+        return false;
+    }
+
+    for (std::size_t i = 0; i < links_; ++i)
+    {
+        const Eigen::Vector3d &position = poses[i].translation();
+        const Eigen::Quaterniond orientation = TF::getPoseRotation(poses[i]);
+
+        float *values = &current_[i * STRIDE];
+        values[0] = position.x();
+        values[1] = position.y();
+        values[2] = position.z();
+        values[3] = orientation.x();
+        values[4] = orientation.y();
+        values[5] = orientation.z();
+        values[6] = orientation.w();
+    }
+
+    const bool keyframe = keyframe_interval_ <= 1 or frames_ % keyframe_interval_ == 0;
+
+    writeValue(out_, keyframe ? KEYFRAME : DELTA);
+    writeValue(out_, duration);
+
+    if (keyframe)
+    {
+        out_.write(reinterpret_cast<const char *>(current_.data()), current_.size() * sizeof(float));
+        previous_ = current_;
+    }
+    else
+    {
+        std::fill(mask_.begin(), mask_.end(), 0);
+        for (std::size_t i = 0; i < links_; ++i)
+            for (std::size_t j = 0; j < STRIDE; ++j)
+                if (std::abs(current_[i * STRIDE + j] - previous_[i * STRIDE + j]) > tolerance_)
+                {
+                    mask_[i / 8] |= 1 << (i % 8);
+                    break;
+                }
+
+        out_.write(reinterpret_cast<const char *>(mask_.data()), mask_.size());
+
+        // Only moved links are updated, so unmoved links keep the values a reader has.
+        for (std::size_t i = 0; i < links_; ++i)
+            if (mask_[i / 8] & (1 << (i % 8)))
+            {
+                out_.write(reinterpret_cast<const char *>(&current_[i * STRIDE]), STRIDE * sizeof(float));
+                std::copy(&current_[i * STRIDE], &current_[(i + 1) * STRIDE], &previous_[i * STRIDE]);
+            }
+    }
+
+    frames_++;
+    return out_.good();
+}
+
+std::size_t IO::AnimationWriter::getFrameCount() const
+{
+    return frames_;
+}
+
+bool IO::AnimationWriter::close()
+{
+    if (not out_.is_open())
+        return false;
+
+    out_.close();
+    return not out_.fail();
+}
+
+///
+/// IO::AnimationReader
+///
+
+IO::AnimationReader::AnimationReader(const std::string &filename)
+  : in_(IO::resolvePath(filename), std::ios::binary)
+{
+    if (not in_)
+    {
+        RBX_ERROR("Failed to open `%1%`", filename);
+        return;
+    }
+
+    char magic[MAGIC_SIZE];
+    uint32_t keyframe_interval, links;
+    if (not in_.read(magic, MAGIC_SIZE) or std::memcmp(magic, MAGIC, MAGIC_SIZE) != 0 or
+        not readValue(in_, fps_) or not readValue(in_, keyframe_interval) or not readValue(in_, links))
+    {
+        RBX_ERROR("`%1%` is not an animation file", filename);
+        return;
+    }
+
+    for (uint32_t i = 0; i < links; ++i)
+    {
+        uint32_t size;
+        if (not readValue(in_, size))
+            return;
+
+        std::string link(size, '\0');
+        if (not in_.read(&link[0], size))
+            return;
+
+        links_.emplace_back(link);
+    }
+
+    frame_.resize(links_.size() * STRIDE);
+    mask_.resize((links_.size() + 7) / 8);
+    valid_ = true;
+}
+
+bool IO::AnimationReader::isOpen() const
+{
+    return valid_;
+}
+
+double IO::AnimationReader::getFPS() const
+{
+    return fps_;
+}
+
+const std::vector<std::string> &IO::AnimationReader::getLinks() const
+{
+    return links_;
+}
+
+bool IO::AnimationReader::next(double &duration)
+{
+    if (not valid_)
+        return false;
+
+    uint8_t type;
+    if (not readValue(in_, type) or not readValue(in_, duration))
+        return false;
+
+    if (type == KEYFRAME)
+        return static_cast<bool>(
+            in_.read(reinterpret_cast<char *>(frame_.data()), frame_.size() * sizeof(float)));
+
+    if (type != DELTA or not in_.read(reinterpret_cast<char *>(mask_.data()), mask_.size()))
+        return false;
+
+    for (std::size_t i = 0; i < links_.size(); ++i)
+        if (mask_[i / 8] & (1 << (i % 8)))
+            if (not in_.read(reinterpret_cast<char *>(&frame_[i * STRIDE]), STRIDE * sizeof(float)))
+                return false;
+
+    return true;
+}
+
+RobotPose IO::AnimationReader::getPose(std::size_t index) const
+{
+    const float *values = &frame_[index * STRIDE];
+    return TF::createPoseQ(values[0], values[1], values[2],  //
+                           values[6], values[3], values[4], values[5]);
+}
+
+geometry_msgs::Pose IO::AnimationReader::getPoseMsg(std::size_t index) const
+{
+    const float *values = &frame_[index * STRIDE];
+
+    geometry_msgs::Pose msg;
+    msg.position.x = values[0];
+    msg.position.y = values[1];
+    msg.position.z = values[2];
+    msg.orientation.x = values[3];
+    msg.orientation.y = values[4];
+    msg.orientation.z = values[5];
+    msg.orientation.w = values[6];
+
+    return msg;
+}
+
+bool IO::AnimationReader::toYAMLFile(const std::string &filename)
+{
+    if (not valid_)
+        return false;
+
+    YAML::Node node, values;
+
+    double duration;
+    while (next(duration))
+    {
+        YAML::Node point;
+        for (std::size_t i = 0; i < links_.size(); ++i)
+            point[links_[i]] = IO::toNode(getPoseMsg(i));
+
+        YAML::Node value;
+        value["point"] = point;
+        value["duration"] = duration;
+        values.push_back(value);
+    }
+
+    node["transforms"] = values;
+    node["fps"] = fps_;
+
+    return IO::YAMLToFile(node, filename);
+}
@@ -1,6 +1,7 @@
 /* Author: Zachary Kingston */
 
 #include <sensor_msgs/JointState.h>
+#include <tf2_msgs/TFMessage.h>
 
 #include <robowflex_library/io/broadcaster.h>
 #include <robowflex_library/log.h>
@@ -22,24 +23,30 @@ IO::RobotBroadcaster::RobotBroadcaster(const RobotConstPtr &robot, const std::st
   : robot_(robot), base_(base_frame), nh_("/" + name)
 {
     state_pub_ = nh_.advertise<sensor_msgs::JointState>("/joint_states", 1);
+    static_pub_ = nh_.advertise<tf2_msgs::TFMessage>("/tf_static", 1, true);
+
+    publisher_ = [&](const std::vector<geometry_msgs::TransformStamped> &transforms) {
+        tf2br_.sendTransform(transforms);
+    };
+
+    static_publisher_ = [&](const std::vector<geometry_msgs::TransformStamped> &transforms) {
+        tf2_msgs::TFMessage msg;
+        msg.transforms = transforms;
+        static_pub_.publish(msg);
+    };
 }
 
 IO::RobotBroadcaster::~RobotBroadcaster()
 {
-    active_ = false;
-    while (not done_)
-    {
-        ros::WallDuration pause(1. / rate_);
-        pause.sleep();
-    }
+    stop();
 }
 
 void IO::RobotBroadcaster::start()
 {
+    stop();
+
     active_ = true;
     thread_.reset(new std::thread([&]() {
-        done_ = false;
-
         while (active_)
         {
             update();
@@ -47,19 +54,23 @@ void IO::RobotBroadcaster::start()
             ros::WallDuration pause(1. / rate_);
             pause.sleep();
         }
-
-        done_ = true;
     }));
 }
 
 void IO::RobotBroadcaster::stop()
 {
     active_ = false;
+    if (thread_)
+    {
+        thread_->join();
+        thread_.reset();
+    }
 }
 
 void IO::RobotBroadcaster::addStaticTransform(const std::string &name, const std::string &base,
                                               const std::string &target, const RobotPose &tf)
 {
+    std::unique_lock<std::mutex> lock(mutex_);
     if (static_.find(name) == static_.end())
     {
         StaticTransform stf;
@@ -68,6 +79,7 @@ void IO::RobotBroadcaster::addStaticTransform(const std::string &name, const std
         stf.tf = tf;
 
         static_.emplace(name, stf);
+        publishStatic();
     }
     else
         RBX_ERROR("Static transform %s already in map!", name);
@@ -75,38 +87,121 @@ void IO::RobotBroadcaster::addStaticTransform(const std::string &name, const std
 
 void IO::RobotBroadcaster::removeStaticTransform(const std::string &name)
 {
+    std::unique_lock<std::mutex> lock(mutex_);
     auto it = static_.find(name);
     if (it != static_.end())
+    {
         static_.erase(it);
+        publishStatic();
+    }
     else
         RBX_ERROR("Static transform %s does not exist in map!", name);
 }
 
+void IO::RobotBroadcaster::setKeepAlive(double period)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    keep_alive_ = period;
+}
+
+void IO::RobotBroadcaster::setTolerance(double tolerance)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    tolerance_ = tolerance;
+}
+
+void IO::RobotBroadcaster::setTransformPublishers(const TransformPublisher &publisher,
+                                                  const TransformPublisher &static_publisher)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    publisher_ = publisher;
+    static_publisher_ = static_publisher;
+
+    sent_.clear();
+    publishStatic();
+}
+
+IO::RobotBroadcaster::Stats IO::RobotBroadcaster::getStats() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void IO::RobotBroadcaster::publishStatic()
+{
+    // The latched message is replaced, so the whole set is sent each time.
+    std::vector<geometry_msgs::TransformStamped> transforms;
+    for (const auto &pair : static_)
+    {
+        const auto &stf = pair.second;
+        transforms.emplace_back(TF::transformEigenToMsg(stf.base, stf.target, stf.tf));
+    }
+
+    static_publisher_(transforms);
+    stats_.static_batches++;
+}
+
 void IO::RobotBroadcaster::update()
 {
     const auto &state = robot_->getScratchStateConst();
     const auto &model = robot_->getModelConst();
+    const auto &links = model->getLinkModels();
 
-    for (const auto &link : model->getLinkModels())
     {
-        const auto &parent = link->getParentLinkModel();
+        std::unique_lock<std::mutex> lock(mutex_);
 
-        RobotPose tf =
-            link->getJointOriginTransform() * state->getJointTransform(link->getParentJointModel());
+        const auto &now = ros::WallTime::now();
+        if (stats_.updates == 0)
+            first_update_ = now;
 
-        std::string source = (parent) ? parent->getName() : base_;
-        const std::string &target = link->getName();
+        // Send all transforms the first time, and periodically after so listeners do not lose them.
+        bool send = sent_.size() != links.size() or (now - last_all_).toSec() >= keep_alive_;
+        transforms_.resize(links.size());
+        for (std::size_t i = 0; i < links.size(); ++i)
+        {
+            const auto &link = links[i];
+            transforms_[i] =
+                link->getJointOriginTransform() * state->getJointTransform(link->getParentJointModel());
 
-        auto msg = TF::transformEigenToMsg(source, target, tf);
+            if (not send and (transforms_[i].matrix() - sent_[i].matrix()).cwiseAbs().maxCoeff() > tolerance_)
+                send = true;
+        }
 
-        tf2br_.sendTransform(msg);
-    }
+        // TF only looks up a frame at a time every transform on its chain to the base is known at, and all
+        // chains share the root. So if any link moved, all are sent with the same stamp, or lookups through
+        // the unchanged links would lag behind.
+        batch_.clear();
+        if (send)
+        {
+            sent_ = transforms_;
+            last_all_ = now;
+
+            for (std::size_t i = 0; i < links.size(); ++i)
+            {
+                const auto &link = links[i];
+                const auto &parent = link->getParentLinkModel();
+                std::string source = (parent) ? parent->getName() : base_;
+                batch_.emplace_back(TF::transformEigenToMsg(source, link->getName(), sent_[i]));
+            }
+        }
+        else
+            stats_.skipped += links.size();
 
-    for (const auto &pair : static_)
-    {
-        const auto &stf = pair.second;
-        auto static_msg = TF::transformEigenToMsg(stf.base, stf.target, stf.tf);
-        tf2br_.sendTransform(static_msg);
+        if (not batch_.empty())
+        {
+            publisher_(batch_);
+            stats_.batches++;
+            stats_.sent += batch_.size();
+        }
+
+        stats_.updates++;
+
+        const double elapsed = (now - first_update_).toSec();
+        if (elapsed > 0)
+        {
+            stats_.update_rate = (stats_.updates - 1) / elapsed;
+            stats_.send_rate = stats_.sent / elapsed;
+        }
     }
 
     unsigned int n = state->getVariableCount();
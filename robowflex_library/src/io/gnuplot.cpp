@@ -1,5 +1,8 @@
 /* Author: Zachary Kingston */
 
+#include <atomic>
+#include <chrono>
+
 #include <robowflex_library/util.h>
 #include <robowflex_library/log.h>
 #include <robowflex_library/io.h>
@@ -51,6 +54,138 @@ void GNUPlotHelper::Instance::flush()
 #endif
 }
 
+void GNUPlotHelper::Instance::sync()
+{
+#if IS_BOOST_164
+    // GNUPlot runs commands in order and prints to its error output, so once a marker printed after the
+    // commands is read back, they are done.
+    static std::atomic<std::size_t> count{0};
+    const auto &marker = log::format("robowflex_sync_%1%", count++);
+    writeline(log::format("print \"%1%\"", marker));
+
+    std::string line;
+    while (gnuplot_.running() and std::getline(error_, line) and line != marker)
+        RBX_WARN("GNUPlot: %1%", line);
+#endif
+}
+
+GNUPlotHelper::LivePlot::LivePlot(const std::shared_ptr<Instance> &instance, double rate)
+  : instance_(instance)
+  , rate_(rate)
+  , directory_(boost::filesystem::temp_directory_path() /
+               boost::filesystem::unique_path("robowflex_gnuplot_%%%%-%%%%-%%%%"))
+{
+    boost::filesystem::create_directories(directory_);
+    thread_ = std::thread([this] { run(); });
+}
+
+GNUPlotHelper::LivePlot::~LivePlot()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+
+    cv_.notify_all();
+    thread_.join();
+
+    // GNUPlot reads the data files asynchronously, so wait for the last plot before removing them.
+    instance_->sync();
+
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(directory_, ec);
+}
+
+void GNUPlotHelper::LivePlot::append(const std::string &name, const Series &points)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto &pending = pending_[name];
+        pending.insert(pending.end(), points.begin(), points.end());
+    }
+
+    cv_.notify_all();
+}
+
+void GNUPlotHelper::LivePlot::run()
+{
+    auto last = std::chrono::steady_clock::now() - std::chrono::hours(1);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        cv_.wait(lock, [&] { return not pending_.empty() or done_; });
+
+        // Limit the rate of replots. Points appended while waiting are plotted together.
+        if (not done_ and rate_ > 0)
+        {
+            const auto next = last + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(1. / rate_));
+            cv_.wait_until(lock, next, [&] { return done_; });
+        }
+
+        std::map<std::string, Series> points;
+        points.swap(pending_);
+        const bool done = done_;
+
+        lock.unlock();
+        if (not points.empty())
+        {
+            plot(points);
+            last = std::chrono::steady_clock::now();
+        }
+        lock.lock();
+
+        if (done)
+            break;
+    }
+}
+
+void GNUPlotHelper::LivePlot::plot(const std::map<std::string, Series> &points)
+{
+    bool added = false;
+    for (const auto &series : points)
+    {
+        auto it = files_.find(series.first);
+        if (it == files_.end())
+        {
+            const auto &file = directory_ / log::format("series%1%.csv", files_.size());
+            it = files_.emplace(series.first, file.string()).first;
+            added = true;
+        }
+
+        std::ofstream out(it->second, std::ofstream::out | std::ofstream::app);
+        for (const auto &point : series.second)
+            out << log::format("%1%,%2%", point.first, point.second) << std::endl;
+    }
+
+    // Existing series only need to be reread, but new series need a new plot command.
+    if (not added)
+    {
+        instance_->writeline("replot");
+        return;
+    }
+
+    instance_->write("plot ");
+
+    std::size_t i = 0;
+    for (const auto &file : files_)
+    {
+        instance_->write(log::format("'%1%' using 1:2 with lines lw 2 title \"%2%\"",  //
+                                     file.second, file.first));
+        if (++i != files_.size())
+            instance_->write(", ");
+    }
+
+    instance_->flush();
+}
+
+GNUPlotHelper::~GNUPlotHelper()
+{
+    std::unique_lock<std::mutex> lock(live_mutex_);
+    live_.clear();
+}
+
 void GNUPlotHelper::configurePlot(const PlottingOptions &options)
 {
     auto in = getInstance(options.instance);
@@ -67,6 +202,8 @@ void GNUPlotHelper::configurePlot(const PlottingOptions &options)
     if (std::isfinite(options.x.min))
         in->writeline(log::format("set xrange [%1%:]", options.x.min));
 
+    in->writeline(log::format("%1% logscale x", (options.x.log) ? "set" : "unset"));
+
     if (not options.y.label.empty())
         in->writeline(log::format("set ylabel \"%1%\"", options.y.label));
 
@@ -75,10 +212,13 @@ void GNUPlotHelper::configurePlot(const PlottingOptions &options)
 
     if (std::isfinite(options.y.min))
         in->writeline(log::format("set yrange [%1%:]", options.y.min));
+
+    in->writeline(log::format("%1% logscale y", (options.y.log) ? "set" : "unset"));
 }
 
 void GNUPlotHelper::timeseries(const TimeSeriesOptions &options)
 {
+    stopLivePlot(options.instance);
     configurePlot(options);
     auto in = getInstance(options.instance);
 
@@ -109,8 +249,46 @@ void GNUPlotHelper::timeseries(const TimeSeriesOptions &options)
     }
 }
 
+void GNUPlotHelper::startLiveTimeseries(const LiveTimeSeriesOptions &options)
+{
+    stopLivePlot(options.instance);
+
+    configurePlot(options);
+    auto in = getInstance(options.instance);
+
+    in->writeline("set datafile separator \",\"");
+
+    std::unique_lock<std::mutex> lock(live_mutex_);
+    live_.emplace(options.instance, std::make_shared<LivePlot>(in, options.rate));
+}
+
+void GNUPlotHelper::appendLiveTimeseries(const std::string &instance, const std::string &name,
+                                         const Series &points)
+{
+    std::shared_ptr<LivePlot> plot;
+    {
+        std::unique_lock<std::mutex> lock(live_mutex_);
+        auto it = live_.find(instance);
+        if (it == live_.end())
+        {
+            RBX_ERROR("No live plot on GNUPlot instance `%1%`", instance);
+            return;
+        }
+
+        plot = it->second;
+    }
+
+    plot->append(name, points);
+}
+
+void GNUPlotHelper::stopLiveTimeseries(const std::string &instance)
+{
+    stopLivePlot(instance);
+}
+
 void GNUPlotHelper::boxplot(const BoxPlotOptions &options)
 {
+    stopLivePlot(options.instance);
     configurePlot(options);
     auto in = getInstance(options.instance);
 
@@ -162,6 +340,22 @@ void GNUPlotHelper::boxplot(const BoxPlotOptions &options)
     }
 }
 
+void GNUPlotHelper::stopLivePlot(const std::string &name)
+{
+    std::shared_ptr<LivePlot> plot;
+    {
+        std::unique_lock<std::mutex> lock(live_mutex_);
+        auto it = live_.find(name);
+        if (it == live_.end())
+            return;
+
+        plot = it->second;
+        live_.erase(it);
+    }
+
+    // Destroyed outside the lock, as remaining points are plotted first.
+}
+
 std::shared_ptr<GNUPlotHelper::Instance> GNUPlotHelper::getInstance(const std::string &name)
 {
     if (instances_.find(name) == instances_.end())
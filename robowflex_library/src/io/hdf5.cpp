@@ -1,11 +1,17 @@
 /* Author: Zachary Kingston */
 
+#include <fstream>
 #include <iostream>
 #include <numeric>
 
+#include <boost/algorithm/string/join.hpp>
+
 #include <robowflex_library/io.h>
 #include <robowflex_library/io/hdf5.h>
+#include <robowflex_library/log.h>
 #include <robowflex_library/macros.h>
+#include <robowflex_library/robot.h>
+#include <robowflex_library/trajectory.h>
 #include <robowflex_library/util.h>
 
 using namespace robowflex;
@@ -15,7 +21,7 @@ using namespace robowflex;
 ///
 
 template <typename T>
-IO::HDF5Data::HDF5Data(const T &location, const std::string &name)
+IO::HDF5Data::HDF5Data(const T &location, const std::string &name, bool lazy)
   : dataset_(location.openDataSet(name))
   , space_(dataset_.getSpace())
   , type_(dataset_.getTypeClass())
@@ -25,23 +31,17 @@ IO::HDF5Data::HDF5Data(const T &location, const std::string &name)
       space_.getSimpleExtentDims(dims);
       return dims;
   }())
-  , data_([&] {
-      const auto &properties = getDataProperties();
-      void *data = std::malloc(std::get<1>(properties) *  //
-                               std::accumulate(dims_, dims_ + rank_, 1, std::multiplies<hsize_t>()));
-
-      dataset_.read(data, std::get<0>(properties), space_, space_);
-      return data;
-  }())
 {
+    if (not lazy)
+        load();
 }
 
-template IO::HDF5Data::HDF5Data(const H5::H5File &, const std::string &);
-template IO::HDF5Data::HDF5Data(const H5::Group &, const std::string &);
+template IO::HDF5Data::HDF5Data(const H5::H5File &, const std::string &, bool);
+template IO::HDF5Data::HDF5Data(const H5::Group &, const std::string &, bool);
 
 IO::HDF5Data::~HDF5Data()
 {
-    delete dims_;
+    delete[] dims_;
 
     // clang-format off
     ROBOWFLEX_PUSH_DISABLE_GCC_WARNING(-Wcast-qual)
@@ -58,9 +58,65 @@ const std::vector<hsize_t> IO::HDF5Data::getDims() const
 
 const void *IO::HDF5Data::getData() const
 {
+    return load();
+}
+
+bool IO::HDF5Data::isLoaded() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return data_ != nullptr;
+}
+
+const void *IO::HDF5Data::load() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (data_)
+        return data_;
+
+    const auto &properties = getDataProperties();
+    void *data = std::malloc(std::get<1>(properties) *  //
+                             std::accumulate(dims_, dims_ + rank_, 1, std::multiplies<hsize_t>()));
+
+    dataset_.read(data, std::get<0>(properties), space_, space_);
+    data_ = data;
     return data_;
 }
 
+bool IO::HDF5Data::read(const std::vector<hsize_t> &offset, const std::vector<hsize_t> &count,
+                        void *buffer) const
+{
+    if (offset.size() != (unsigned int)rank_ or count.size() != (unsigned int)rank_)
+    {
+        RBX_ERROR("Hyperslab offset and count must be the same size as data rank %1%!", rank_);
+        return false;
+    }
+
+    for (int i = 0; i < rank_; ++i)
+        if (offset[i] + count[i] > dims_[i])
+        {
+            RBX_ERROR("Hyperslab is out of bounds at dimension %1%: %2% + %3% > %4%",  //
+                      i, offset[i], count[i], dims_[i]);
+            return false;
+        }
+
+    try
+    {
+        // Get a new dataspace, as copies share their selection.
+        H5::DataSpace file_space = dataset_.getSpace();
+        file_space.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+
+        H5::DataSpace memory_space(rank_, count.data());
+        dataset_.read(buffer, std::get<0>(getDataProperties()), memory_space, file_space);
+    }
+    catch (H5::Exception &e)
+    {
+        RBX_ERROR("Failed to read hyperslab: %1%", e.getDetailMsg());
+        return false;
+    }
+
+    return true;
+}
+
 const std::string IO::HDF5Data::getStatus() const
 {
     std::stringstream ss;
@@ -101,7 +157,7 @@ const T &IO::HDF5Data::get(const std::vector<hsize_t> &index) const
     if (index.size() != (unsigned int)rank_)
         throw Exception(1, "Index size must be the same as data rank!");
 
-    const T *data = reinterpret_cast<const T *>(data_);
+    const T *data = reinterpret_cast<const T *>(load());
     unsigned int offset = 0;
 
     for (int i = 0; i < rank_; ++i)
@@ -140,8 +196,21 @@ std::tuple<H5::PredType, unsigned int, std::string> IO::HDF5Data::getDataPropert
 /// IO::HDF5File
 ///
 
-IO::HDF5File::HDF5File(const std::string &filename)
-  : file_(IO::resolvePath(filename), H5F_ACC_RDONLY), data_(NodeMap())
+IO::HDF5File::HDF5File(const std::string &filename, bool lazy) : HDF5File(filename, lazy, CacheOptions())
+{
+}
+
+IO::HDF5File::HDF5File(const std::string &filename, bool lazy, const CacheOptions &cache)
+  : lazy_(lazy)
+  , file_(IO::resolvePath(filename), H5F_ACC_RDONLY, H5::FileCreatPropList::DEFAULT,
+          [&] {
+              H5::FileAccPropList access;
+
+              // The number of metadata cache elements is ignored by HDF5.
+              access.setCache(0, cache.slots, cache.bytes, cache.w0);
+              return access;
+          }())
+  , data_(NodeMap())
 {
     for (const auto &obj : listObjects(file_))
         loadData(data_, file_, obj);
@@ -217,6 +286,45 @@ namespace
     }
 };  // namespace
 
+namespace
+{
+    const std::string TRAJECTORIES = "trajectories";  // Group of written trajectories.
+    const std::string STATES = "states";              // Group of written states.
+
+    void writeStringAttribute(const H5::H5Object &object, const std::string &name, const std::string &value)
+    {
+        H5::StrType type(H5::PredType::C_S1, std::max<std::size_t>(value.size(), 1));
+        auto attribute = object.createAttribute(name, type, H5::DataSpace(H5S_SCALAR));
+        attribute.write(type, value);
+    }
+
+    std::string readStringAttribute(const H5::H5Object &object, const std::string &name)
+    {
+        if (H5Aexists(object.getId(), name.c_str()) <= 0)
+            return "";
+
+        const auto &attribute = object.openAttribute(name);
+
+        std::string value;
+        attribute.read(attribute.getStrType(), value);
+        return value;
+    }
+
+    std::vector<double> readDataset(const H5::Group &group, const std::string &name, hsize_t &rows)
+    {
+        const auto &dataset = group.openDataSet(name);
+        const auto &space = dataset.getSpace();
+
+        std::vector<hsize_t> dims(space.getSimpleExtentNdims());
+        space.getSimpleExtentDims(dims.data());
+        rows = dims[0];
+
+        std::vector<double> data(std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<hsize_t>()));
+        dataset.read(data.data(), H5::PredType::NATIVE_DOUBLE);
+        return data;
+    }
+}  // namespace
+
 const IO::HDF5DataPtr IO::HDF5File::getData(const std::vector<std::string> &keys) const
 {
     const NodeMap &node = boost::get<NodeMap>(data_);
@@ -234,6 +342,55 @@ const std::vector<std::vector<std::string>> IO::HDF5File::getKeys() const
     return keys;
 }
 
+std::vector<std::string> IO::HDF5File::getTrajectoryNames() const
+{
+    if (H5Lexists(file_.getId(), TRAJECTORIES.c_str(), H5P_DEFAULT) <= 0)
+        return {};
+
+    return listObjects(file_.openGroup(TRAJECTORIES));
+}
+
+TrajectoryPtr IO::HDF5File::getTrajectory(const std::string &name, const RobotConstPtr &robot) const
+{
+    try
+    {
+        const auto &group = file_.openGroup(TRAJECTORIES + "/" + name);
+
+        moveit_msgs::RobotTrajectory msg;
+        auto &joint_trajectory = msg.joint_trajectory;
+        joint_trajectory.joint_names = IO::tokenize<std::string>(readStringAttribute(group, "joint_names"));
+
+        hsize_t rows;
+        const auto &positions = readDataset(group, "positions", rows);
+        const auto &times = readDataset(group, "time", rows);
+
+        std::vector<double> velocities;
+        if (H5Lexists(group.getId(), "velocities", H5P_DEFAULT) > 0)
+            velocities = readDataset(group, "velocities", rows);
+
+        const std::size_t n = joint_trajectory.joint_names.size();
+        joint_trajectory.points.resize(rows);
+        for (std::size_t i = 0; i < rows; ++i)
+        {
+            auto &point = joint_trajectory.points[i];
+            point.positions.assign(positions.begin() + i * n, positions.begin() + (i + 1) * n);
+            if (not velocities.empty())
+                point.velocities.assign(velocities.begin() + i * n, velocities.begin() + (i + 1) * n);
+
+            point.time_from_start = ros::Duration(times[i]);
+        }
+
+        auto trajectory = std::make_shared<Trajectory>(robot, readStringAttribute(group, "group"));
+        trajectory->useMessage(*robot->getScratchStateConst(), msg);
+        return trajectory;
+    }
+    catch (H5::Exception &e)
+    {
+        RBX_ERROR("Failed to read trajectory `%1%`: %2%", name, e.getDetailMsg());
+        return nullptr;
+    }
+}
+
 template <typename T>
 std::vector<std::string> IO::HDF5File::listObjects(const T &location) const
 {
@@ -272,7 +429,7 @@ void IO::HDF5File::loadData(Node &node, const T &location, const std::string &na
         }
         case H5O_TYPE_DATASET:
         {
-            map[name] = std::make_shared<HDF5Data>(location, name);
+            map[name] = std::make_shared<HDF5Data>(location, name, lazy_);
             break;
         }
 
@@ -285,3 +442,252 @@ void IO::HDF5File::loadData(Node &node, const T &location, const std::string &na
 
 template void IO::HDF5File::loadData(Node &, const H5::H5File &, const std::string &);
 template void IO::HDF5File::loadData(Node &, const H5::Group &, const std::string &);
+
+///
+/// IO::HDF5Writer
+///
+
+IO::HDF5Writer::HDF5Writer(const std::string &filename) : HDF5Writer(filename, Options())
+{
+}
+
+IO::HDF5Writer::HDF5Writer(const std::string &filename, const Options &options)
+  : options_(options), file_([&] {
+      std::ofstream out;
+      IO::createFile(out, filename);  // Create parent directories.
+      return H5::H5File(filename, H5F_ACC_TRUNC);
+  }())
+{
+    file_.createGroup(TRAJECTORIES);
+    file_.createGroup(STATES);
+
+    thread_ = std::thread([this] { run(); });
+}
+
+IO::HDF5Writer::~HDF5Writer()
+{
+    flush();
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        active_ = false;
+    }
+
+    cv_.notify_all();
+    thread_.join();
+}
+
+void IO::HDF5Writer::addTrajectory(const std::string &name, const Trajectory &trajectory)
+{
+    const auto &msg = trajectory.getMessage().joint_trajectory;
+    const std::size_t n = msg.joint_names.size();
+    if (n == 0)
+    {
+        RBX_ERROR("Trajectory `%1%` has no joints", name);
+        return;
+    }
+
+    Job job;
+    job.type = Job::TRAJECTORY;
+    job.name = name;
+    job.group = trajectory.getTrajectoryConst()->getGroupName();
+    job.joint_names = msg.joint_names;
+    job.rows = msg.points.size();
+
+    bool velocities = true;
+    for (const auto &point : msg.points)
+    {
+        if (point.positions.size() != n)
+        {
+            RBX_ERROR("Waypoint has %1% positions, expected %2% for `%3%`", point.positions.size(), n, name);
+            return;
+        }
+
+        job.positions.insert(job.positions.end(), point.positions.begin(), point.positions.end());
+        job.times.emplace_back(point.time_from_start.toSec());
+        velocities &= point.velocities.size() == n;
+    }
+
+    if (velocities)
+        for (const auto &point : msg.points)
+            job.velocities.insert(job.velocities.end(), point.velocities.begin(), point.velocities.end());
+
+    submit(std::move(job));
+}
+
+void IO::HDF5Writer::addStates(const std::string &name, const std::vector<std::string> &joint_names,
+                               const std::vector<std::vector<double>> &states)
+{
+    if (joint_names.empty())
+    {
+        RBX_ERROR("States for `%1%` have no joints", name);
+        return;
+    }
+
+    Job job;
+    job.type = Job::STATES;
+    job.name = name;
+    job.joint_names = joint_names;
+
+    for (const auto &state : states)
+    {
+        if (state.size() != joint_names.size())
+        {
+            RBX_ERROR("State has %1% values, expected %2% for `%3%`", state.size(), joint_names.size(), name);
+            return;
+        }
+
+        job.positions.insert(job.positions.end(), state.begin(), state.end());
+    }
+
+    job.rows = states.size();
+    submit(std::move(job));
+}
+
+void IO::HDF5Writer::flush()
+{
+    Job job;
+    job.type = Job::FLUSH;
+    submit(std::move(job));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&] { return pending_ == 0; });
+}
+
+void IO::HDF5Writer::submit(Job &&job)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queue_.emplace(std::move(job));
+        pending_++;
+    }
+
+    cv_.notify_one();
+}
+
+void IO::HDF5Writer::run()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return not active_ or not queue_.empty(); });
+
+            if (queue_.empty())
+                return;
+
+            job = std::move(queue_.front());
+            queue_.pop();
+        }
+
+        try
+        {
+            switch (job.type)
+            {
+                case Job::TRAJECTORY:
+                    writeTrajectory(job);
+                    break;
+                case Job::STATES:
+                    writeStates(job);
+                    break;
+                case Job::FLUSH:
+                    file_.flush(H5F_SCOPE_GLOBAL);
+                    break;
+            }
+        }
+        catch (H5::Exception &e)
+        {
+            RBX_ERROR("Failed to write `%1%`: %2%", job.name, e.getDetailMsg());
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            pending_--;
+        }
+
+        done_.notify_all();
+    }
+}
+
+void IO::HDF5Writer::writeTrajectory(const Job &job)
+{
+    const auto &trajectories = file_.openGroup(TRAJECTORIES);
+    if (H5Lexists(trajectories.getId(), job.name.c_str(), H5P_DEFAULT) > 0)
+    {
+        RBX_ERROR("Trajectory `%1%` already exists", job.name);
+        return;
+    }
+
+    const auto &group = trajectories.createGroup(job.name);
+    writeStringAttribute(group, "group", job.group);
+    writeStringAttribute(group, "joint_names", boost::algorithm::join(job.joint_names, " "));
+
+    const hsize_t cols = job.joint_names.size();
+    writeDataset(group, "positions", job.positions, job.rows, cols);
+    if (not job.velocities.empty())
+        writeDataset(group, "velocities", job.velocities, job.rows, cols);
+
+    writeDataset(group, "time", job.times, job.rows, 0);
+}
+
+void IO::HDF5Writer::writeStates(const Job &job)
+{
+    const hsize_t cols = job.joint_names.size();
+    const auto &states = file_.openGroup(STATES);
+
+    // Create the dataset on the first batch, with no rows.
+    if (H5Lexists(states.getId(), job.name.c_str(), H5P_DEFAULT) <= 0)
+    {
+        const auto &group = states.createGroup(job.name);
+        writeStringAttribute(group, "joint_names", boost::algorithm::join(job.joint_names, " "));
+        writeDataset(group, "positions", {}, 0, cols);
+    }
+
+    const auto &group = states.openGroup(job.name);
+    if (readStringAttribute(group, "joint_names") != boost::algorithm::join(job.joint_names, " "))
+    {
+        RBX_ERROR("Joint names of states do not match dataset `%1%`", job.name);
+        return;
+    }
+
+    if (job.rows == 0)
+        return;
+
+    auto dataset = group.openDataSet("positions");
+
+    hsize_t dims[2];
+    dataset.getSpace().getSimpleExtentDims(dims);
+
+    const hsize_t extended[2] = {dims[0] + job.rows, cols};
+    dataset.extend(extended);
+
+    const hsize_t offset[2] = {dims[0], 0};
+    const hsize_t count[2] = {job.rows, cols};
+
+    H5::DataSpace file_space = dataset.getSpace();
+    file_space.selectHyperslab(H5S_SELECT_SET, count, offset);
+
+    H5::DataSpace memory_space(2, count);
+    dataset.write(job.positions.data(), H5::PredType::NATIVE_DOUBLE, memory_space, file_space);
+}
+
+void IO::HDF5Writer::writeDataset(const H5::Group &group, const std::string &name,
+                                  const std::vector<double> &data, hsize_t rows, hsize_t cols)
+{
+    const int rank = (cols > 0) ? 2 : 1;
+    const hsize_t dims[2] = {rows, cols};
+    const hsize_t max[2] = {H5S_UNLIMITED, cols};
+    const hsize_t chunk[2] = {std::max<hsize_t>(1, options_.chunk_rows), std::max<hsize_t>(1, cols)};
+
+    H5::DSetCreatPropList properties;
+    properties.setChunk(rank, chunk);
+    if (options_.compression > 0)
+        properties.setDeflate(options_.compression);
+
+    const auto &dataset =
+        group.createDataSet(name, H5::PredType::NATIVE_DOUBLE, H5::DataSpace(rank, dims, max), properties);
+
+    if (rows > 0)
+        dataset.write(data.data(), H5::PredType::NATIVE_DOUBLE);
+}
@@ -1,5 +1,7 @@
 /* Author: Zachary Kingston, Constantinos Chamzas */
 
+#include <chrono>
+
 #include <boost/range/combine.hpp>
 
 #include <moveit_msgs/DisplayRobotState.h>
@@ -34,6 +36,38 @@ namespace
         color::turbo(RNG::uniform01(), color);
         return color;
     }
+
+    /** Get at most \a m indices evenly spread over \a n elements, including the first and last. */
+    std::vector<std::size_t> getSampleIndices(std::size_t n, std::size_t m)
+    {
+        std::vector<std::size_t> indices;
+        if (m == 0 or n <= m)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                indices.emplace_back(i);
+        }
+        else if (m == 1)
+            indices.emplace_back(n - 1);
+        else
+            for (std::size_t i = 0; i < m; ++i)
+                indices.emplace_back((i * (n - 1) + (m - 1) / 2) / (m - 1));
+
+        return indices;
+    }
+
+    /** Keep only points of a trajectory message at the given indices. */
+    template <typename T>
+    void samplePoints(std::vector<T> &points, const std::vector<std::size_t> &indices)
+    {
+        if (points.empty() or indices.size() == points.size())
+            return;
+
+        std::vector<T> sampled;
+        for (const auto &index : indices)
+            sampled.emplace_back(std::move(points[index]));
+
+        points = std::move(sampled);
+    }
 };  // namespace
 
 IO::RVIZHelper::RVIZHelper(const RobotConstPtr &robot, const std::string &name)
@@ -52,6 +86,29 @@ IO::RVIZHelper::RVIZHelper(const RobotConstPtr &robot, const std::string &name)
     scene_pub_ = nh_.advertise<moveit_msgs::PlanningScene>("scene", 1);
     pcd_pub_ = nh_.advertise<sensor_msgs::PointCloud2>("pcd", 1);
     marker_pub_ = nh_.advertise<visualization_msgs::MarkerArray>("/visualization_marker_array", 100);
+
+    trajectory_thread_ = std::thread([this] { publishTrajectories(); });
+}
+
+IO::RVIZHelper::~RVIZHelper()
+{
+    {
+        std::unique_lock<std::mutex> lock(trajectory_mutex_);
+        done_ = true;
+        flush_deadline_ = std::chrono::steady_clock::now() +
+                          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double>(trajectory_options_.flush_timeout));
+    }
+
+    // Wakes the thread to publish the pending update, if any, without waiting for the rate limit.
+    trajectory_cv_.notify_all();
+    trajectory_thread_.join();
+}
+
+void IO::RVIZHelper::setTrajectoryOptions(const TrajectoryOptions &options)
+{
+    std::unique_lock<std::mutex> lock(trajectory_mutex_);
+    trajectory_options_ = options;
 }
 
 void IO::RVIZHelper::updateTrajectory(const planning_interface::MotionPlanResponse &response)
@@ -66,10 +123,14 @@ void IO::RVIZHelper::updateTrajectory(const Trajectory &trajectory)
 
 void IO::RVIZHelper::updateTrajectory(const robot_trajectory::RobotTrajectoryPtr &trajectory)
 {
-    moveit_msgs::RobotTrajectory msg;
-    trajectory->getRobotTrajectoryMsg(msg);
+    moveit_msgs::DisplayTrajectory out;
+
+    out.model_id = robot_->getModelName();
+    out.trajectory.resize(1);
+    toTrajectoryMsg(trajectory, out.trajectory[0]);
+    moveit::core::robotStateToRobotStateMsg(trajectory->getFirstWayPoint(), out.trajectory_start);
 
-    updateTrajectory(msg, trajectory->getFirstWayPoint());
+    queueTrajectory(std::move(out));
 }
 
 void IO::RVIZHelper::updateTrajectory(const moveit_msgs::RobotTrajectory &traj,
@@ -81,16 +142,21 @@ void IO::RVIZHelper::updateTrajectory(const moveit_msgs::RobotTrajectory &traj,
     out.trajectory.push_back(traj);
     moveit::core::robotStateToRobotStateMsg(start, out.trajectory_start);
 
-    if (trajectory_pub_.getNumSubscribers() < 1)
+    std::size_t max_waypoints;
     {
-        RBX_INFO("Waiting for Trajectory subscribers...");
-
-        ros::WallDuration pause(0.1);
-        while (trajectory_pub_.getNumSubscribers() < 1)
-            pause.sleep();
+        std::unique_lock<std::mutex> lock(trajectory_mutex_);
+        max_waypoints = trajectory_options_.max_waypoints;
     }
 
-    trajectory_pub_.publish(out);
+    auto &joint_points = out.trajectory[0].joint_trajectory.points;
+    auto &multi_dof_points = out.trajectory[0].multi_dof_joint_trajectory.points;
+    const auto &indices = getSampleIndices(std::max(joint_points.size(), multi_dof_points.size()),  //
+                                           max_waypoints);
+
+    samplePoints(joint_points, indices);
+    samplePoints(multi_dof_points, indices);
+
+    queueTrajectory(std::move(out));
 }
 
 void IO::RVIZHelper::updateTrajectories(const std::vector<robot_trajectory::RobotTrajectoryPtr> &trajectories)
@@ -98,30 +164,28 @@ void IO::RVIZHelper::updateTrajectories(const std::vector<robot_trajectory::Robo
     moveit_msgs::DisplayTrajectory out;
     out.model_id = robot_->getModelName();
 
+    std::size_t max_trajectories;
+    {
+        std::unique_lock<std::mutex> lock(trajectory_mutex_);
+        max_trajectories = trajectory_options_.max_trajectories;
+    }
+
+    // Only trajectories that are kept are converted.
     bool set = false;
-    for (const auto &traj : trajectories)
+    for (const auto &index : getSampleIndices(trajectories.size(), max_trajectories))
     {
+        const auto &traj = trajectories[index];
         if (!set)
         {
             moveit::core::robotStateToRobotStateMsg(traj->getFirstWayPoint(), out.trajectory_start);
             set = true;
         }
 
-        moveit_msgs::RobotTrajectory msg;
-        traj->getRobotTrajectoryMsg(msg);
-        out.trajectory.push_back(msg);
-    }
-
-    if (trajectory_pub_.getNumSubscribers() < 1)
-    {
-        RBX_INFO("Waiting for Trajectory subscribers...");
-
-        ros::WallDuration pause(0.1);
-        while (trajectory_pub_.getNumSubscribers() < 1)
-            pause.sleep();
+        out.trajectory.emplace_back();
+        toTrajectoryMsg(traj, out.trajectory.back());
     }
 
-    trajectory_pub_.publish(out);
+    queueTrajectory(std::move(out));
 }
 
 void IO::RVIZHelper::updateTrajectories(const std::vector<planning_interface::MotionPlanResponse> &responses)
@@ -145,6 +209,95 @@ void IO::RVIZHelper::updateTrajectories(const std::vector<TrajectoryPtr> &trajec
     updateTrajectories(moveit_trajectories);
 }
 
+void IO::RVIZHelper::toTrajectoryMsg(const robot_trajectory::RobotTrajectoryPtr &trajectory,
+                                     moveit_msgs::RobotTrajectory &msg) const
+{
+    std::size_t max_waypoints;
+    {
+        std::unique_lock<std::mutex> lock(trajectory_mutex_);
+        max_waypoints = trajectory_options_.max_waypoints;
+    }
+
+    const std::size_t n = trajectory->getWayPointCount();
+    if (max_waypoints == 0 or n <= max_waypoints)
+    {
+        trajectory->getRobotTrajectoryMsg(msg);
+        return;
+    }
+
+    // Waypoints are shared, not copied, and durations are summed over dropped waypoints.
+    robot_trajectory::RobotTrajectory sampled(trajectory->getRobotModel(), trajectory->getGroup());
+
+    double last = 0;
+    for (const auto &index : getSampleIndices(n, max_waypoints))
+    {
+        const double time = trajectory->getWayPointDurationFromStart(index);
+        sampled.addSuffixWayPoint(trajectory->getWayPointPtr(index), time - last);
+        last = time;
+    }
+
+    sampled.getRobotTrajectoryMsg(msg);
+}
+
+void IO::RVIZHelper::queueTrajectory(moveit_msgs::DisplayTrajectory &&out)
+{
+    {
+        std::unique_lock<std::mutex> lock(trajectory_mutex_);
+        pending_.reset(new moveit_msgs::DisplayTrajectory(std::move(out)));
+    }
+
+    trajectory_cv_.notify_all();
+}
+
+void IO::RVIZHelper::publishTrajectories()
+{
+    auto last = std::chrono::steady_clock::now() - std::chrono::hours(1);
+
+    std::unique_lock<std::mutex> lock(trajectory_mutex_);
+    while (true)
+    {
+        trajectory_cv_.wait(lock, [&] { return pending_ or done_; });
+        if (not pending_)
+            break;
+
+        // Limit the rate of updates. Updates made while waiting replace the pending update. On
+        // destruction, the last update is published right away.
+        if (trajectory_options_.rate > 0 and not done_)
+        {
+            const auto next = last + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(1. / trajectory_options_.rate));
+            trajectory_cv_.wait_until(lock, next, [&] { return done_; });
+        }
+
+        if (trajectory_pub_.getNumSubscribers() < 1)
+        {
+            RBX_INFO("Waiting for Trajectory subscribers...");
+
+            ros::WallDuration pause(0.1);
+            while (trajectory_pub_.getNumSubscribers() < 1 and
+                   (not done_ or std::chrono::steady_clock::now() < flush_deadline_))
+            {
+                lock.unlock();
+                pause.sleep();
+                lock.lock();
+            }
+
+            if (trajectory_pub_.getNumSubscribers() < 1)
+            {
+                RBX_WARN("Discarding trajectory update, as there are no subscribers");
+                break;
+            }
+        }
+
+        std::unique_ptr<moveit_msgs::DisplayTrajectory> out = std::move(pending_);
+
+        lock.unlock();
+        trajectory_pub_.publish(*out);
+        last = std::chrono::steady_clock::now();
+        lock.lock();
+    }
+}
+
 void IO::RVIZHelper::visualizeState(const robot_state::RobotStatePtr &state)
 {
     if (state_pub_.getNumSubscribers() < 1)
@@ -1,11 +1,20 @@
 /* Author: Bryce Willey */
 
 #include <algorithm>
+#include <cstdio>  // for std::rename
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
 #include <stack>
 
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+
 #include <tinyxml2.h>
 
 #include <ros/console.h>
+#include <ros/serialization.h>
 
 #include <geometry_msgs/Pose.h>
 
@@ -18,6 +27,7 @@
 #include <robowflex_library/io.h>
 #include <robowflex_library/log.h>
 #include <robowflex_library/openrave.h>
+#include <robowflex_library/pool.h>
 #include <robowflex_library/tf.h>
 
 using namespace robowflex;
@@ -25,10 +35,20 @@ using namespace robowflex::openrave;
 
 namespace
 {
+    /** A mesh referenced by a collision object, loaded after the XML is scanned. */
+    struct MeshReference
+    {
+        std::size_t object;        // Index of the collision object.
+        std::string resource;      // Resolved path to the mesh.
+        geometry_msgs::Pose pose;  // Pose of the mesh.
+    };
+
     struct SceneParsingContext
     {
         RobotPose robot_offset;
         std::vector<moveit_msgs::CollisionObject> coll_objects;
+        std::vector<MeshReference> meshes;
+        std::set<std::string> files;  // All files referenced by the environment.
         std::stack<std::string> directory_stack;
     };
 
@@ -83,8 +103,7 @@ namespace
         return tf;
     }
 
-    bool parseKinbody(SceneParsingContext &load_struct, tinyxml2::XMLElement *elem, const RobotPose &tf,
-                      moveit_msgs::PlanningScene &planning_scene)
+    bool parseKinbody(SceneParsingContext &load_struct, tinyxml2::XMLElement *elem, const RobotPose &tf)
     {
         if (not elem)
         {
@@ -102,14 +121,18 @@ namespace
             // We need to read in another file to get the actual info.
             std::string full_path = load_struct.directory_stack.top() + "/" + std::string(filename);
             tinyxml2::XMLDocument doc;
-            if (!doc.LoadFile(full_path.c_str()))
+            if (doc.LoadFile(full_path.c_str()) != tinyxml2::XML_SUCCESS)
             {
                 RBX_ERROR("Cannot load file %s", full_path);
                 return false;
             }
 
+            load_struct.files.emplace(full_path);
             load_struct.directory_stack.push(IO::resolveParent(full_path));
-            return parseKinbody(load_struct, getFirstChild(&doc, "KinBody"), tf * this_tf, planning_scene);
+            bool r = parseKinbody(load_struct, getFirstChild(&doc, "KinBody"), tf * this_tf);
+            load_struct.directory_stack.pop();
+
+            return r;
         }
 
         tinyxml2::XMLElement *body_elem = getFirstChild(elem);
@@ -149,8 +172,6 @@ namespace
                 if (geom_str == "trimesh")
                 {
                     // Set resource
-                    Eigen::Vector3d dimensions{1, 1, 1};
-
                     tinyxml2::XMLElement *data = getFirstChild(geom, "Data");
                     std::string resource_path;
                     if (data)
@@ -162,17 +183,21 @@ namespace
                         tinyxml2::XMLElement *render = getFirstChild(geom, "Render");
                         if (render)
                             resource_path =
-                                load_struct.directory_stack.top() + "/" + std::string(data->GetText());
+                                load_struct.directory_stack.top() + "/" + std::string(render->GetText());
                         else
                         {
                             RBX_ERROR("Malformed File: No Data or Render Elements inside a trimesh Geom.");
                             return false;
                         }
                     }
-                    auto mesh = Geometry::makeMesh(resource_path, dimensions);
 
-                    coll_obj.meshes.push_back(mesh->getMeshMsg());
-                    coll_obj.mesh_poses.push_back(pose_msg);
+                    // Meshes are loaded in parallel once the whole environment is scanned.
+                    const auto &resolved = IO::resolvePath(resource_path);
+                    if (resolved.empty())
+                        return false;
+
+                    load_struct.files.emplace(resolved);
+                    load_struct.meshes.push_back({load_struct.coll_objects.size(), resolved, pose_msg});
                 }
 
                 if (geom_str == "box")
@@ -196,17 +221,136 @@ namespace
                 coll_obj.operation = moveit_msgs::CollisionObject::ADD;
 
                 load_struct.coll_objects.push_back(coll_obj);
-                planning_scene.world.collision_objects.push_back(coll_obj);
             }
         }
 
-        load_struct.directory_stack.pop();
         return true;
     }
+
+    /** Loads all meshes referenced by the scanned environment in parallel, each unique mesh once. */
+    bool loadMeshes(SceneParsingContext &load_struct, unsigned int threads)
+    {
+        std::set<std::string> resources;
+        for (const auto &mesh : load_struct.meshes)
+            resources.emplace(mesh.resource);
+
+        Pool pool(std::max(1u, threads));
+
+        using MeshJob = std::shared_ptr<Pool::Job<std::pair<bool, shape_msgs::Mesh>>>;
+        std::map<std::string, MeshJob> jobs;
+        for (const auto &resource : resources)
+        {
+            auto load = [resource] {
+                const auto &geometry = Geometry::makeMesh(resource);
+                if (not geometry->getShape())
+                    return std::make_pair(false, shape_msgs::Mesh());
+
+                return std::make_pair(true, geometry->getMeshMsg());
+            };
+
+            jobs.emplace(resource, pool.submit(make_function(load)));
+        }
+
+        std::map<std::string, shape_msgs::Mesh> loaded;
+        for (const auto &job : jobs)
+        {
+            const auto &result = job.second->get();
+            if (not result.first)
+            {
+                RBX_ERROR("Cannot load mesh %s", job.first);
+                return false;
+            }
+
+            loaded.emplace(job.first, result.second);
+        }
+
+        for (const auto &mesh : load_struct.meshes)
+        {
+            auto &coll_obj = load_struct.coll_objects[mesh.object];
+            coll_obj.meshes.push_back(loaded[mesh.resource]);
+            coll_obj.mesh_poses.push_back(mesh.pose);
+        }
+
+        return true;
+    }
+
+    /** Hashes the contents of the environment and all files it references. */
+    std::string getCacheFile(const std::string &cache_directory, const std::string &file,
+                             const std::set<std::string> &files)
+    {
+        // Fowler-Noll-Vo hash, which is stable between runs and platforms.
+        uint64_t hash = 14695981039346656037ULL;
+        auto hashFile = [&hash](const std::string &path) {
+            std::ifstream in(path, std::ios::binary);
+            char buffer[4096];
+            while (in.read(buffer, sizeof(buffer)) or in.gcount() > 0)
+                for (std::streamsize i = 0; i < in.gcount(); ++i)
+                {
+                    hash ^= static_cast<unsigned char>(buffer[i]);
+                    hash *= 1099511628211ULL;
+                }
+        };
+
+        hashFile(file);
+        for (const auto &referenced : files)
+            hashFile(referenced);
+
+        boost::filesystem::path path = IO::resolvePackage(cache_directory);
+        path /= (boost::format("%016x.scene") % hash).str();
+        return path.string();
+    }
+
+    bool loadCacheFile(moveit_msgs::PlanningScene &planning_scene, const std::string &file)
+    {
+        std::ifstream in(file, std::ios::binary);
+        if (not in)
+            return false;
+
+        std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        try
+        {
+            ros::serialization::IStream stream(buffer.data(), buffer.size());
+            ros::serialization::deserialize(stream, planning_scene);
+        }
+        catch (ros::serialization::StreamOverrunException &e)
+        {
+            RBX_WARN("Ignoring invalid cached scene %s", file);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool saveCacheFile(const moveit_msgs::PlanningScene &planning_scene, const std::string &file)
+    {
+        const uint32_t size = ros::serialization::serializationLength(planning_scene);
+        std::vector<uint8_t> buffer(size);
+
+        ros::serialization::OStream stream(buffer.data(), size);
+        ros::serialization::serialize(stream, planning_scene);
+
+        // Write to a temporary file first, and then move it over the output.
+        const auto &temporary = file + ".tmp";
+
+        std::ofstream out;
+        IO::createFile(out, temporary);
+        if (not out)
+        {
+            RBX_WARN("Cannot write cached scene %s", temporary);
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char *>(buffer.data()), size);
+        out.close();
+
+        return std::rename(temporary.c_str(), file.c_str()) == 0;
+    }
 }  // namespace
 
 bool openrave::fromXMLFile(moveit_msgs::PlanningScene &planning_scene, const std::string &file,
-                           const std::string &model_dir)
+                           const std::string &model_dir, unsigned int threads,
+                           const std::string &cache_directory)
 {
     SceneParsingContext load_struct;
     load_struct.directory_stack.push(model_dir);
@@ -217,8 +361,10 @@ bool openrave::fromXMLFile(moveit_msgs::PlanningScene &planning_scene, const std
     tf.linear() = Eigen::Quaterniond::Identity().toRotationMatrix();
     load_struct.robot_offset = tf;
 
+    const auto &full_path = IO::resolvePath(file);
+
     tinyxml2::XMLDocument doc;
-    if (!doc.LoadFile(IO::resolvePath(file).c_str()))
+    if (doc.LoadFile(full_path.c_str()) != tinyxml2::XML_SUCCESS)
     {
         RBX_ERROR("Cannot load file %s", file);
         return false;
@@ -238,18 +384,44 @@ bool openrave::fromXMLFile(moveit_msgs::PlanningScene &planning_scene, const std
         return false;
     }
 
+    // First, scan the XML for collision objects and the meshes they reference.
     for (; elem; elem = elem->NextSiblingElement())
     {
         const std::string p_key = std::string(elem->Value());
         if (p_key == "KinBody")
         {
-            if (!parseKinbody(load_struct, elem, load_struct.robot_offset.inverse(), planning_scene))
+            if (!parseKinbody(load_struct, elem, load_struct.robot_offset.inverse()))
                 return false;
         }
         else
             RBX_INFO("Ignoring elements of value %s", p_key);
     }
 
+    // Then, load the meshes in parallel, or all collision objects from the cache if the environment and the
+    // files it references have not changed.
+    std::string cache_file;
+    moveit_msgs::PlanningScene cached;
+    if (not cache_directory.empty())
+        cache_file = getCacheFile(cache_directory, full_path, load_struct.files);
+
+    if (not cache_file.empty() and loadCacheFile(cached, cache_file))
+        load_struct.coll_objects = cached.world.collision_objects;
+    else
+    {
+        if (not loadMeshes(load_struct, threads))
+            return false;
+
+        if (not cache_file.empty())
+        {
+            cached.world.collision_objects = load_struct.coll_objects;
+            saveCacheFile(cached, cache_file);
+        }
+    }
+
+    planning_scene.world.collision_objects.insert(planning_scene.world.collision_objects.end(),
+                                                  load_struct.coll_objects.begin(),
+                                                  load_struct.coll_objects.end());
+
     if (not load_struct.coll_objects.empty())
         planning_scene.is_diff = true;
 
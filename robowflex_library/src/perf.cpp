@@ -0,0 +1,167 @@
+/* Author: Zachary Kingston */
+
+#include <sys/time.h>      // for timeval
+#include <sys/resource.h>  // for getrusage
+#include <unistd.h>        // for close, read
+
+#if defined(__linux__)
+#include <linux/perf_event.h>  // for perf_event_attr
+#include <sys/ioctl.h>         // for ioctl
+#include <sys/syscall.h>       // for syscall
+#endif
+
+#include <cstring>  // for std::memset
+
+#include <robowflex_library/perf.h>
+
+using namespace robowflex;
+
+namespace
+{
+    double toSeconds(const timeval &tv)
+    {
+        return tv.tv_sec + tv.tv_usec / 1000000.;
+    }
+
+    void getCPUTime(double &user, double &system)
+    {
+        // The whole process, as planners may plan in worker threads that are not inherited from the caller.
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            user = toSeconds(usage.ru_utime);
+            system = toSeconds(usage.ru_stime);
+        }
+    }
+
+#if defined(__linux__)
+    int openCounter(uint32_t type, uint64_t config)
+    {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // Measure the calling thread (and its children) on any CPU.
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+}  // namespace
+
+///
+/// PerfCounters::Sample
+///
+
+bool PerfCounters::Sample::anyAvailable() const
+{
+    for (const auto &a : available)
+        if (a)
+            return true;
+
+    return false;
+}
+
+///
+/// PerfCounters
+///
+
+PerfCounters::PerfCounters()
+{
+    fds_.fill(-1);
+
+#if defined(__linux__)
+    fds_[CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds_[INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[CACHE_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds_[BRANCH_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds_[CONTEXT_SWITCHES] = openCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (const auto &fd : fds_)
+        if (fd >= 0)
+            close(fd);
+}
+
+void PerfCounters::start()
+{
+#if defined(__linux__)
+    for (const auto &fd : fds_)
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+
+    getCPUTime(user_start_, system_start_);
+}
+
+PerfCounters::Sample PerfCounters::stop()
+{
+    Sample sample;
+
+#if defined(__linux__)
+    for (std::size_t i = 0; i < NUM_COUNTERS; ++i)
+    {
+        const int fd = fds_[i];
+        if (fd < 0)
+            continue;
+
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        // Value, time enabled, time running.
+        uint64_t data[3] = {0, 0, 0};
+        if (read(fd, data, sizeof(data)) != sizeof(data))
+            continue;
+
+        // Counter was never scheduled onto the PMU.
+        if (data[2] == 0)
+            continue;
+
+        // Scale for multiplexing if the counter was not running the entire time.
+        double value = static_cast<double>(data[0]);
+        if (data[2] < data[1])
+            value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+
+        sample.values[i] = static_cast<uint64_t>(value);
+        sample.available[i] = true;
+    }
+#endif
+
+    double user = 0., system = 0.;
+    getCPUTime(user, system);
+
+    sample.user_time = user - user_start_;
+    sample.system_time = system - system_start_;
+
+    return sample;
+}
+
+const char *PerfCounters::getName(Counter counter)
+{
+    switch (counter)
+    {
+        case CYCLES:
+            return "cycles";
+        case INSTRUCTIONS:
+            return "instructions";
+        case CACHE_MISSES:
+            return "cache_misses";
+        case BRANCH_MISSES:
+            return "branch_misses";
+        case CONTEXT_SWITCHES:
+            return "context_switches";
+        default:
+            return "unknown";
+    }
+}
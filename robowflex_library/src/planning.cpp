@@ -93,6 +93,102 @@ std::vector<std::string> PoolPlanner::getPlannerConfigs() const
     return planners_.front()->getPlannerConfigs();
 }
 
+///
+/// DeadlinePlanner
+///
+
+DeadlinePlanner::DeadlinePlanner(const PlannerPtr &planner, const std::string &name)
+  : Planner(planner->getRobot(), name), planner_(planner)
+{
+}
+
+void DeadlinePlanner::setDeadline(double deadline)
+{
+    deadline_ = deadline;
+}
+
+void DeadlinePlanner::setMargin(double margin)
+{
+    margin_ = std::min(std::max(margin, 0.), 1. - constants::eps);
+}
+
+const PlannerPtr &DeadlinePlanner::getPlanner() const
+{
+    return planner_;
+}
+
+planning_interface::MotionPlanResponse
+DeadlinePlanner::plan(const SceneConstPtr &scene, const planning_interface::MotionPlanRequest &request)
+{
+    const auto start = IO::getDate();
+    const double deadline = getDeadline(request);
+
+    planning_interface::MotionPlanRequest inner = request;
+    inner.allowed_planning_time = (1. - margin_) * deadline;
+
+    // Capture by value, as the job may outlive this call if the deadline is exceeded.
+    auto planner = planner_;
+    auto job = pool_.submit(make_function([planner, scene, inner] { return planner->plan(scene, inner); }));
+
+    if (job->waitFor(deadline))
+        return job->get();
+
+    // Do not run the job if it has not started yet (e.g., waiting on a previous late job).
+    job->cancel();
+
+    const double time = IO::getSeconds(start, IO::getDate());
+    RBX_WARN("Planner `%1%` exceeded hard deadline of %2% seconds.", planner_->getName(), deadline);
+
+    planning_interface::MotionPlanResponse response;
+    response.error_code_.val = moveit_msgs::MoveItErrorCodes::TIMED_OUT;
+    response.planning_time_ = time;
+
+    return response;
+}
+
+std::vector<std::string> DeadlinePlanner::getPlannerConfigs() const
+{
+    return planner_->getPlannerConfigs();
+}
+
+std::map<std::string, Planner::ProgressProperty> DeadlinePlanner::getProgressProperties(
+    const SceneConstPtr &scene, const planning_interface::MotionPlanRequest &request) const
+{
+    // Run on the planner thread, so a late job from a previous call is done with the wrapped planner first.
+    // Capture by value, as the job may outlive this call.
+    const double deadline = getDeadline(request);
+    auto planner = planner_;
+    auto job = pool_.submit(
+        make_function([planner, scene, request] { return planner->getProgressProperties(scene, request); }));
+
+    if (job->waitFor(deadline))
+        return job->get();
+
+    job->cancel();
+    RBX_WARN("Planner `%1%` still busy after %2% seconds, no progress properties returned.",
+             planner_->getName(), deadline);
+
+    return {};
+}
+
+void DeadlinePlanner::preRun(const SceneConstPtr &scene, const planning_interface::MotionPlanRequest &request)
+{
+    const double deadline = getDeadline(request);
+    auto planner = planner_;
+    auto job = pool_.submit(make_function([planner, scene, request] { planner->preRun(scene, request); }));
+
+    if (job->waitFor(deadline))
+        return;
+
+    job->cancel();
+    RBX_WARN("Planner `%1%` still busy after %2% seconds, skipping pre-run.", planner_->getName(), deadline);
+}
+
+double DeadlinePlanner::getDeadline(const planning_interface::MotionPlanRequest &request) const
+{
+    return (deadline_ > 0.) ? deadline_ : request.allowed_planning_time;
+}
+
 ///
 /// SimpleCartesianPlanner
 ///
@@ -1,6 +1,7 @@
 /* Author: Zachary Kingston */
 
 #include <deque>
+#include <functional>
 #include <numeric>
 
 #include <moveit/robot_state/conversions.h>
@@ -8,6 +9,7 @@
 
 #include <robowflex_library/geometry.h>
 #include <robowflex_library/io.h>
+#include <robowflex_library/io/animation.h>
 #include <robowflex_library/io/yaml.h>
 #include <robowflex_library/log.h>
 #include <robowflex_library/macros.h>
@@ -1150,6 +1152,51 @@ namespace
 
         return TF::poseMsgToEigen(msg);
     }
+
+    /** Get the links of a robot that have visual geometry. */
+    std::vector<const robot_model::LinkModel *> getVisualLinks(const robot_model::RobotModelPtr &model)
+    {
+        std::vector<const robot_model::LinkModel *> links;
+
+        const auto &urdf = model->getURDF();
+        for (const auto &link_name : model->getLinkModelNames())
+            if (urdf->getLink(link_name)->visual)
+                links.emplace_back(model->getLinkModel(link_name));
+
+        return links;
+    }
+
+    /** Sample updated states along a path at a rate, skipping states closer than a threshold to the last
+     * sampled state. The callback is given each state and the time since the last sampled state. */
+    void samplePath(const robot_model::RobotModelPtr &model, const robot_trajectory::RobotTrajectory &path,
+                    double fps, double threshold,
+                    const std::function<void(const robot_state::RobotState &state, double delay)> &callback)
+    {
+        const double rate = 1.0 / fps;
+
+        // Find the total duration of the path.
+        const std::deque<double> &durations = path.getWayPointDurations();
+        double total_duration = std::accumulate(durations.begin(), durations.end(), 0.0);
+
+        robot_state::RobotStatePtr previous, state(new robot_state::RobotState(model));
+
+        for (double duration = 0.0, delay = 0.0; duration <= total_duration; duration += rate, delay += rate)
+        {
+            path.getStateAtDurationFromStart(duration, state);
+            if (previous && state->distance(*previous) < threshold)
+                continue;
+
+            state->update();
+            callback(*state, delay);
+
+            delay = 0;
+
+            if (!previous)
+                previous.reset(new robot_state::RobotState(model));
+
+            *previous = *state;
+        }
+    }
 }  // namespace
 
 bool Robot::dumpGeometry(const std::string &filename) const
@@ -1214,49 +1261,21 @@ bool Robot::dumpPathTransforms(const robot_trajectory::RobotTrajectory &path, co
                                double fps, double threshold) const
 {
     YAML::Node node, values;
-    const double rate = 1.0 / fps;
 
-    // Find the total duration of the path.
-    const std::deque<double> &durations = path.getWayPointDurations();
-    double total_duration = std::accumulate(durations.begin(), durations.end(), 0.0);
-
-    const auto &urdf = model_->getURDF();
-
-    robot_state::RobotStatePtr previous, state(new robot_state::RobotState(model_));
-
-    for (double duration = 0.0, delay = 0.0; duration <= total_duration; duration += rate, delay += rate)
-    {
+    const auto &links = getVisualLinks(model_);
+    samplePath(model_, path, fps, threshold, [&](const robot_state::RobotState &state, double delay) {
         YAML::Node point;
-
-        path.getStateAtDurationFromStart(duration, state);
-        if (previous && state->distance(*previous) < threshold)
-            continue;
-
-        state->update();
-        for (const auto &link_name : model_->getLinkModelNames())
+        for (const auto &link : links)
         {
-            const auto &urdf_link = urdf->getLink(link_name);
-            if (urdf_link->visual)
-            {
-                const auto &link = model_->getLinkModel(link_name);
-                RobotPose tf =
-                    state->getGlobalLinkTransform(link);  // * urdfPoseToEigen(urdf_link->visual->origin);
-                point[link->getName()] = IO::toNode(TF::poseEigenToMsg(tf));
-            }
+            RobotPose tf = state.getGlobalLinkTransform(link);
+            point[link->getName()] = IO::toNode(TF::poseEigenToMsg(tf));
         }
 
         YAML::Node value;
         value["point"] = point;
         value["duration"] = delay;
         values.push_back(value);
-
-        delay = 0;
-
-        if (!previous)
-            previous.reset(new robot_state::RobotState(model_));
-
-        *previous = *state;
-    }
+    });
 
     node["transforms"] = values;
     node["fps"] = fps;
@@ -1264,6 +1283,30 @@ bool Robot::dumpPathTransforms(const robot_trajectory::RobotTrajectory &path, co
     return IO::YAMLToFile(node, filename);
 }
 
+bool Robot::dumpPathAnimation(const robot_trajectory::RobotTrajectory &path, const std::string &filename,
+                              double fps, double threshold, std::size_t keyframe_interval) const
+{
+    const auto &links = getVisualLinks(model_);
+
+    std::vector<std::string> names;
+    for (const auto &link : links)
+        names.emplace_back(link->getName());
+
+    IO::AnimationWriter writer(filename, names, fps, keyframe_interval);
+    if (not writer.isOpen())
+        return false;
+
+    RobotPoseVector poses(links.size());
+    samplePath(model_, path, fps, threshold, [&](const robot_state::RobotState &state, double delay) {
+        for (std::size_t i = 0; i < links.size(); ++i)
+            poses[i] = state.getGlobalLinkTransform(links[i]);
+
+        writer.addFrame(delay, poses);
+    });
+
+    return writer.close();
+}
+
 bool Robot::dumpToScene(const std::string &filename) const
 {
     YAML::Node node;
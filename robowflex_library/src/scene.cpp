@@ -10,6 +10,7 @@
 #include <robowflex_library/openrave.h>
 #include <robowflex_library/robot.h>
 #include <robowflex_library/scene.h>
+#include <robowflex_library/simplify.h>
 #include <robowflex_library/tf.h>
 #include <robowflex_library/util.h>
 
@@ -152,7 +153,8 @@ Scene::Scene(const robot_model::RobotModelConstPtr &robot)
 {
 }
 
-Scene::Scene(const Scene &other) : loader_(new CollisionPluginLoader()), scene_(other.getSceneConst())
+Scene::Scene(const Scene &other)
+  : loader_(new CollisionPluginLoader()), scene_(other.getSceneConst()), simplifier_(other.simplifier_)
 {
 }
 
@@ -160,12 +162,14 @@ void Scene::operator=(const Scene &other)
 {
     incrementVersion();
     scene_ = other.getSceneConst();
+    simplifier_ = other.simplifier_;
 }
 
 ScenePtr Scene::deepCopy() const
 {
     auto scene = std::make_shared<Scene>(scene_->getRobotModel());
     scene->useMessage(getMessage());
+    scene->setMeshSimplifier(simplifier_);
 
     return scene;
 }
@@ -220,6 +224,16 @@ void Scene::useMessage(const moveit_msgs::PlanningScene &msg, bool diff)
         scene_->setPlanningSceneDiffMsg(msg);
 }
 
+void Scene::setMeshSimplifier(const MeshSimplifierPtr &simplifier)
+{
+    simplifier_ = simplifier;
+}
+
+const MeshSimplifierPtr &Scene::getMeshSimplifier() const
+{
+    return simplifier_;
+}
+
 void Scene::fixCollisionObjectFrame(moveit_msgs::PlanningScene &msg)
 {
     for (auto &co : msg.world.collision_objects)
@@ -232,16 +246,26 @@ void Scene::updateCollisionObject(const std::string &name, const GeometryConstPt
 {
     incrementVersion();
 
+    // Simplified shapes are remembered by the simplifier, so the same geometry gives the same shape.
+    shapes::ShapeConstPtr shape = geometry->getShape();
+    RobotPose shape_pose = pose;
+    if (simplifier_ and geometry->isMesh())
+    {
+        const auto &result = simplifier_->simplify(shape);
+        shape = result.shape;
+        shape_pose = pose * result.offset;
+    }
+
     const auto &world = scene_->getWorldNonConst();
     if (world->hasObject(name))
     {
-        if (!world->moveShapeInObject(name, geometry->getShape(), pose))
+        if (!world->moveShapeInObject(name, shape, shape_pose))
             world->removeObject(name);
         else
             return;
     }
 
-    world->addToObject(name, geometry->getShape(), pose);
+    world->addToObject(name, shape, shape_pose);
 }
 
 std::vector<std::string> Scene::getCollisionObjects() const
@@ -602,6 +626,9 @@ bool Scene::fromYAMLFile(const std::string &file)
     if (msg.robot_state.joint_state.position.empty())
         moveit::core::robotStateToRobotStateMsg(scene_->getCurrentState(), msg.robot_state);
 
+    if (simplifier_)
+        simplifier_->simplify(msg);
+
     auto acm(getACM());
     useMessage(msg);
 
@@ -612,15 +639,19 @@ bool Scene::fromYAMLFile(const std::string &file)
     return true;
 }
 
-bool Scene::fromOpenRAVEXMLFile(const std::string &file, std::string models_dir)
+bool Scene::fromOpenRAVEXMLFile(const std::string &file, std::string models_dir,
+                                const std::string &cache_directory)
 {
     if (models_dir.empty())
         models_dir = IO::resolveParent(file);
 
     moveit_msgs::PlanningScene msg;
-    if (!openrave::fromXMLFile(msg, file, models_dir))
+    if (!openrave::fromXMLFile(msg, file, models_dir, std::thread::hardware_concurrency(), cache_directory))
         return false;
 
+    if (simplifier_)
+        simplifier_->simplify(msg);
+
     scene_->usePlanningSceneMsg(msg);
     return true;
 }
@@ -0,0 +1,439 @@
+/* Author: Zachary Kingston */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>  // for std::rename
+#include <fstream>
+#include <set>
+#include <tuple>
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+
+#include <geometric_shapes/bodies.h>
+#include <geometric_shapes/shape_operations.h>
+
+#include <robowflex_library/io.h>
+#include <robowflex_library/log.h>
+#include <robowflex_library/simplify.h>
+#include <robowflex_library/tf.h>
+
+using namespace robowflex;
+
+namespace
+{
+    /** Magic string at the start of cache files, to detect stale or foreign files. */
+    const std::string CACHE_MAGIC = "RBXSIMP1";
+
+    /** Fowler-Noll-Vo hash of bytes, which is stable between runs and platforms. */
+    void hashBytes(uint64_t &hash, const void *data, std::size_t size)
+    {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    /** Create a mesh from vertices and triangles. */
+    shapes::Mesh *makeMesh(const EigenSTL::vector_Vector3d &vertices,
+                           const std::vector<unsigned int> &triangles)
+    {
+        auto *mesh = new shapes::Mesh(vertices.size(), triangles.size() / 3);
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                mesh->vertices[3 * i + j] = vertices[i][j];
+
+        std::copy(triangles.begin(), triangles.end(), mesh->triangles);
+        mesh->computeTriangleNormals();
+        return mesh;
+    }
+
+    template <typename T>
+    void writeValue(std::ofstream &out, const T &value)
+    {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream &in, T &value)
+    {
+        return bool(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+    }
+}  // namespace
+
+MeshSimplifier::MeshSimplifier() : MeshSimplifier(Options())
+{
+}
+
+MeshSimplifier::MeshSimplifier(const Options &options) : options_(options)
+{
+}
+
+MeshSimplifier::Options &MeshSimplifier::getOptions()
+{
+    return options_;
+}
+
+MeshSimplifier::Result MeshSimplifier::simplify(const shapes::ShapeConstPtr &shape)
+{
+    Result result;
+    result.shape = shape;
+
+    if (not shape or shape->type != shapes::MESH)
+        return result;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto &it = memos_.find(shape.get());
+        if (it != memos_.end() and it->second.first.lock() == shape)
+        {
+            result = it->second.second;
+            if (not result.simplified)
+                result.shape = shape;
+
+            return result;
+        }
+    }
+
+    result = compute(static_cast<const shapes::Mesh &>(*shape));
+
+    // Do not keep the original shape in the memo, or it would never expire.
+    Result memo = result;
+    if (not result.simplified)
+    {
+        result.shape = shape;
+        memo.shape.reset();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // Forget shapes that no longer exist, as their addresses may be reused.
+    for (auto it = memos_.begin(); it != memos_.end();)
+        if (it->second.first.expired())
+            it = memos_.erase(it);
+        else
+            ++it;
+
+    memos_[shape.get()] = std::make_pair(shape, memo);
+    return result;
+}
+
+std::size_t MeshSimplifier::simplify(moveit_msgs::PlanningScene &msg)
+{
+    std::size_t count = 0;
+    for (auto &co : msg.world.collision_objects)
+    {
+        std::vector<shape_msgs::Mesh> meshes;
+        std::vector<geometry_msgs::Pose> mesh_poses;
+
+        for (std::size_t i = 0; i < co.meshes.size(); ++i)
+        {
+            const shapes::ShapeConstPtr shape(shapes::constructShapeFromMsg(co.meshes[i]));
+
+            Result result;
+            if (shape)
+                result = compute(static_cast<const shapes::Mesh &>(*shape));
+
+            if (not result.simplified)
+            {
+                meshes.emplace_back(co.meshes[i]);
+                mesh_poses.emplace_back(co.mesh_poses[i]);
+                continue;
+            }
+
+            count++;
+            const auto &pose = TF::poseEigenToMsg(TF::poseMsgToEigen(co.mesh_poses[i]) * result.offset);
+
+            shapes::ShapeMsg shape_msg;
+            shapes::constructMsgFromShape(result.shape.get(), shape_msg);
+
+            if (result.shape->type == shapes::MESH)
+            {
+                meshes.emplace_back(boost::get<shape_msgs::Mesh>(shape_msg));
+                mesh_poses.emplace_back(pose);
+            }
+            else
+            {
+                co.primitives.emplace_back(boost::get<shape_msgs::SolidPrimitive>(shape_msg));
+                co.primitive_poses.emplace_back(pose);
+            }
+        }
+
+        co.meshes = meshes;
+        co.mesh_poses = mesh_poses;
+    }
+
+    return count;
+}
+
+MeshSimplifier::Result MeshSimplifier::compute(const shapes::Mesh &mesh) const
+{
+    Result result;
+    result.triangles = mesh.triangle_count;
+
+    if (mesh.triangle_count < options_.min_triangles)
+        return result;
+
+    const auto &file = getCacheFile(mesh);
+    if (not file.empty() and loadCacheFile(file, result))
+        return result;
+
+    switch (options_.method)
+    {
+        case DECIMATE:
+            result = decimate(mesh);
+            break;
+        case CONVEX_HULL:
+            result = convexHull(mesh);
+            break;
+        case BOX:
+            result = boundingBox(mesh);
+            break;
+        default:
+            break;
+    }
+
+    if (not result.simplified)
+        return result;
+
+    result.triangles = mesh.triangle_count;
+    if (not file.empty())
+        saveCacheFile(file, result);
+
+    return result;
+}
+
+MeshSimplifier::Result MeshSimplifier::decimate(const shapes::Mesh &mesh) const
+{
+    Result result;
+
+    // Vertices are clustered in a grid whose cell diagonal is the maximum error, and each cluster is replaced
+    // by the mean of its vertices. No vertex moves more than the error, and as triangles are linear in their
+    // vertices, neither does any point on the surface.
+    const double cell = options_.max_error / std::sqrt(3.);
+    if (cell <= 0.)
+        return result;
+
+    std::map<std::tuple<long, long, long>, unsigned int> clusters;
+    std::vector<unsigned int> remap(mesh.vertex_count);
+    EigenSTL::vector_Vector3d sums;
+    std::vector<std::size_t> counts;
+
+    for (unsigned int i = 0; i < mesh.vertex_count; ++i)
+    {
+        const Eigen::Vector3d v(mesh.vertices[3 * i], mesh.vertices[3 * i + 1], mesh.vertices[3 * i + 2]);
+        const auto key = std::make_tuple(long(std::floor(v[0] / cell)),  //
+                                         long(std::floor(v[1] / cell)),  //
+                                         long(std::floor(v[2] / cell)));
+
+        const auto &it = clusters.emplace(key, sums.size());
+        if (it.second)
+        {
+            sums.emplace_back(Eigen::Vector3d::Zero());
+            counts.emplace_back(0);
+        }
+
+        remap[i] = it.first->second;
+        sums[remap[i]] += v;
+        counts[remap[i]]++;
+    }
+
+    EigenSTL::vector_Vector3d vertices(sums.size());
+    for (std::size_t i = 0; i < sums.size(); ++i)
+        vertices[i] = sums[i] / counts[i];
+
+    double error = 0.;
+    for (unsigned int i = 0; i < mesh.vertex_count; ++i)
+    {
+        const Eigen::Vector3d v(mesh.vertices[3 * i], mesh.vertices[3 * i + 1], mesh.vertices[3 * i + 2]);
+        error = std::max(error, (vertices[remap[i]] - v).norm());
+    }
+
+    // Drop triangles that collapsed, and duplicates of the same triangle.
+    std::set<std::tuple<unsigned int, unsigned int, unsigned int>> seen;
+    std::vector<unsigned int> triangles;
+    for (unsigned int i = 0; i < mesh.triangle_count; ++i)
+    {
+        unsigned int t[3] = {remap[mesh.triangles[3 * i]],      //
+                             remap[mesh.triangles[3 * i + 1]],  //
+                             remap[mesh.triangles[3 * i + 2]]};
+
+        if (t[0] == t[1] or t[1] == t[2] or t[0] == t[2])
+            continue;
+
+        unsigned int s[3] = {t[0], t[1], t[2]};
+        std::sort(s, s + 3);
+        if (not seen.emplace(s[0], s[1], s[2]).second)
+            continue;
+
+        triangles.insert(triangles.end(), t, t + 3);
+    }
+
+    if (triangles.empty())
+        return result;
+
+    result.simplified = true;
+    result.shape.reset(makeMesh(vertices, triangles));
+    result.simplified_triangles = triangles.size() / 3;
+    result.error = error;
+    return result;
+}
+
+MeshSimplifier::Result MeshSimplifier::convexHull(const shapes::Mesh &mesh) const
+{
+    Result result;
+
+    const bodies::ConvexMesh body(&mesh);
+    const auto &triangles = body.getTriangles();
+    if (triangles.empty())
+        return result;
+
+    result.simplified = true;
+    result.shape.reset(makeMesh(body.getVertices(), triangles));
+    result.simplified_triangles = triangles.size() / 3;
+    return result;
+}
+
+MeshSimplifier::Result MeshSimplifier::boundingBox(const shapes::Mesh &mesh) const
+{
+    Result result;
+    if (mesh.vertex_count == 0)
+        return result;
+
+    Eigen::AlignedBox3d box;
+    for (unsigned int i = 0; i < mesh.vertex_count; ++i)
+        box.extend(Eigen::Vector3d(mesh.vertices[3 * i], mesh.vertices[3 * i + 1], mesh.vertices[3 * i + 2]));
+
+    const Eigen::Vector3d &size = box.sizes();
+
+    result.simplified = true;
+    result.shape = std::make_shared<shapes::Box>(size[0], size[1], size[2]);
+    result.offset = TF::createPoseXYZ(box.center());
+    result.simplified_triangles = 12;
+    return result;
+}
+
+std::string MeshSimplifier::getCacheFile(const shapes::Mesh &mesh) const
+{
+    if (options_.cache_directory.empty())
+        return "";
+
+    uint64_t hash = 14695981039346656037ULL;
+    hashBytes(hash, mesh.vertices, 3 * mesh.vertex_count * sizeof(double));
+    hashBytes(hash, mesh.triangles, 3 * mesh.triangle_count * sizeof(unsigned int));
+
+    const auto method = int(options_.method);
+    hashBytes(hash, &method, sizeof(method));
+    if (options_.method == DECIMATE)
+        hashBytes(hash, &options_.max_error, sizeof(options_.max_error));
+
+    boost::filesystem::path file = IO::resolvePackage(options_.cache_directory);
+    file /= (boost::format("%016x.mesh") % hash).str();
+    return file.string();
+}
+
+bool MeshSimplifier::loadCacheFile(const std::string &file, Result &result)
+{
+    std::ifstream in(file, std::ios::binary);
+    if (not in)
+        return false;
+
+    std::string magic(CACHE_MAGIC.size(), '\0');
+    if (not in.read(&magic[0], magic.size()) or magic != CACHE_MAGIC)
+    {
+        RBX_WARN("Ignoring invalid mesh cache file `%1%`", file);
+        return false;
+    }
+
+    int type;
+    Eigen::Vector3d offset;
+    uint64_t simplified_triangles;
+    if (not readValue(in, type) or not readValue(in, offset[0]) or not readValue(in, offset[1])
+        or not readValue(in, offset[2]) or not readValue(in, result.error)
+        or not readValue(in, simplified_triangles))
+        return false;
+
+    if (type == shapes::BOX)
+    {
+        Eigen::Vector3d size;
+        if (not readValue(in, size[0]) or not readValue(in, size[1]) or not readValue(in, size[2]))
+            return false;
+
+        result.shape = std::make_shared<shapes::Box>(size[0], size[1], size[2]);
+    }
+    else
+    {
+        uint64_t nv, nt;
+        if (not readValue(in, nv) or not readValue(in, nt))
+            return false;
+
+        std::shared_ptr<shapes::Mesh> mesh(new shapes::Mesh(nv, nt));
+        if (not in.read(reinterpret_cast<char *>(mesh->vertices), 3 * nv * sizeof(double))
+            or not in.read(reinterpret_cast<char *>(mesh->triangles), 3 * nt * sizeof(unsigned int)))
+            return false;
+
+        mesh->computeTriangleNormals();
+        result.shape = mesh;
+    }
+
+    result.simplified = true;
+    result.offset = TF::createPoseXYZ(offset);
+    result.simplified_triangles = simplified_triangles;
+    return true;
+}
+
+bool MeshSimplifier::saveCacheFile(const std::string &file, const Result &result)
+{
+    // Write to a temporary file first, and then move it over the output, so concurrent readers do not see
+    // partially written files.
+    // The temporary file name is unique, so processes writing the same cache file do not clobber each other.
+    const auto &temporary = file + boost::filesystem::unique_path(".%%%%-%%%%-%%%%.tmp").string();
+
+    std::ofstream out;
+    IO::createFile(out, temporary);
+    if (not out)
+    {
+        RBX_WARN("Failed to open mesh cache file `%1%` for writing", temporary);
+        return false;
+    }
+
+    out.write(CACHE_MAGIC.data(), CACHE_MAGIC.size());
+
+    const int type = result.shape->type;
+    const Eigen::Vector3d offset = result.offset.translation();
+    writeValue(out, type);
+    writeValue(out, offset[0]);
+    writeValue(out, offset[1]);
+    writeValue(out, offset[2]);
+    writeValue(out, result.error);
+    writeValue(out, uint64_t(result.simplified_triangles));
+
+    if (type == shapes::BOX)
+    {
+        const auto &box = static_cast<const shapes::Box &>(*result.shape);
+        writeValue(out, box.size[0]);
+        writeValue(out, box.size[1]);
+        writeValue(out, box.size[2]);
+    }
+    else
+    {
+        const auto &mesh = static_cast<const shapes::Mesh &>(*result.shape);
+        writeValue(out, uint64_t(mesh.vertex_count));
+        writeValue(out, uint64_t(mesh.triangle_count));
+        out.write(reinterpret_cast<const char *>(mesh.vertices), 3 * mesh.vertex_count * sizeof(double));
+        out.write(reinterpret_cast<const char *>(mesh.triangles),
+                  3 * mesh.triangle_count * sizeof(unsigned int));
+    }
+
+    out.close();
+    if (std::rename(temporary.c_str(), file.c_str()) != 0)
+    {
+        RBX_WARN("Failed to move `%1%` to `%2%`", temporary, file);
+        boost::filesystem::remove(temporary);
+        return false;
+    }
+
+    return true;
+}
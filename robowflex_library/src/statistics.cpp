@@ -0,0 +1,350 @@
+/* Author: Zachary Kingston */
+
+#include <algorithm>  // for std::sort
+#include <cmath>      // for std::sqrt, std::floor, std::erfc
+#include <limits>     // for std::numeric_limits
+#include <numeric>    // for std::accumulate
+#include <utility>    // for std::pair
+
+#include <robowflex_library/statistics.h>
+
+using namespace robowflex;
+
+namespace
+{
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+}
+
+double stats::mean(const std::vector<double> &values)
+{
+    if (values.empty())
+        return NaN;
+
+    return std::accumulate(values.begin(), values.end(), 0.) / values.size();
+}
+
+double stats::variance(const std::vector<double> &values)
+{
+    if (values.size() < 2)
+        return 0.;
+
+    const double mu = mean(values);
+
+    double sum = 0.;
+    for (const auto &value : values)
+        sum += (value - mu) * (value - mu);
+
+    return sum / (values.size() - 1);
+}
+
+double stats::quantile(std::vector<double> values, double q)
+{
+    std::sort(values.begin(), values.end());
+    return quantileSorted(values, q);
+}
+
+double stats::quantileSorted(const std::vector<double> &sorted, double q)
+{
+    if (sorted.empty())
+        return NaN;
+
+    q = std::min(std::max(q, 0.), 1.);
+
+    const double rank = q * (sorted.size() - 1);
+    const auto lower = static_cast<std::size_t>(std::floor(rank));
+    const auto upper = std::min(lower + 1, sorted.size() - 1);
+    const double t = rank - lower;
+
+    return (1. - t) * sorted[lower] + t * sorted[upper];
+}
+
+stats::Summary stats::summarize(const std::vector<double> &values)
+{
+    std::vector<double> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+
+    Summary summary;
+    summary.n = sorted.size();
+    summary.mean = mean(sorted);
+    summary.stddev = (sorted.empty()) ? NaN : std::sqrt(variance(sorted));
+    summary.min = (sorted.empty()) ? NaN : sorted.front();
+    summary.q25 = quantileSorted(sorted, 0.25);
+    summary.median = quantileSorted(sorted, 0.5);
+    summary.q75 = quantileSorted(sorted, 0.75);
+    summary.q95 = quantileSorted(sorted, 0.95);
+    summary.max = (sorted.empty()) ? NaN : sorted.back();
+
+    return summary;
+}
+
+stats::PowerLaw stats::fitPowerLaw(const std::vector<double> &x, const std::vector<double> &y)
+{
+    std::vector<double> lx, ly;
+    for (std::size_t i = 0; i < std::min(x.size(), y.size()); ++i)
+        if (std::isfinite(x[i]) and std::isfinite(y[i]) and x[i] > 0. and y[i] > 0.)
+        {
+            lx.emplace_back(std::log(x[i]));
+            ly.emplace_back(std::log(y[i]));
+        }
+
+    PowerLaw fit{NaN, NaN, NaN};
+    if (lx.size() < 2)
+        return fit;
+
+    const double mx = mean(lx);
+    const double my = mean(ly);
+
+    double sxx = 0., sxy = 0., syy = 0.;
+    for (std::size_t i = 0; i < lx.size(); ++i)
+    {
+        sxx += (lx[i] - mx) * (lx[i] - mx);
+        sxy += (lx[i] - mx) * (ly[i] - my);
+        syy += (ly[i] - my) * (ly[i] - my);
+    }
+
+    if (sxx <= 0.)
+        return fit;
+
+    fit.exponent = sxy / sxx;
+    fit.coefficient = std::exp(my - fit.exponent * mx);
+    fit.r2 = (syy > 0.) ? (sxy * sxy) / (sxx * syy) : 1.;
+
+    return fit;
+}
+
+double stats::normalCDF(double z)
+{
+    return 0.5 * std::erfc(-z / std::sqrt(2.));
+}
+
+stats::TestResult stats::mannWhitneyU(const std::vector<double> &a, const std::vector<double> &b)
+{
+    TestResult result{0., 0., 1., 0.};
+    if (a.empty() or b.empty())
+        return result;
+
+    const double n1 = a.size();
+    const double n2 = b.size();
+    const double n = n1 + n2;
+
+    // Pool both samples, remembering which sample each value came from.
+    std::vector<std::pair<double, bool>> pooled;
+    for (const auto &value : a)
+        pooled.emplace_back(value, true);
+    for (const auto &value : b)
+        pooled.emplace_back(value, false);
+
+    std::sort(pooled.begin(), pooled.end(),
+              [](const std::pair<double, bool> &x, const std::pair<double, bool> &y) {  //
+                  return x.first < y.first;
+              });
+
+    // Sum ranks of the first sample, averaging ranks over ties.
+    double rank_sum = 0.;
+    double ties = 0.;
+    for (std::size_t i = 0; i < pooled.size();)
+    {
+        std::size_t j = i;
+        while (j < pooled.size() and pooled[j].first == pooled[i].first)
+            ++j;
+
+        const double t = j - i;
+        const double rank = (i + 1 + j) / 2.;
+        for (std::size_t k = i; k < j; ++k)
+            if (pooled[k].second)
+                rank_sum += rank;
+
+        ties += t * t * t - t;
+        i = j;
+    }
+
+    const double u = rank_sum - n1 * (n1 + 1) / 2.;
+    const double mu = n1 * n2 / 2.;
+    const double sigma = std::sqrt(n1 * n2 / 12. * ((n + 1) - ties / (n * (n - 1))));
+
+    result.statistic = u;
+    result.effect = 2. * u / (n1 * n2) - 1.;
+
+    if (sigma > 0.)
+    {
+        const double d = u - mu;
+        const double correction = (d > 0.) ? 0.5 : ((d < 0.) ? -0.5 : 0.);
+        result.z = (d - correction) / sigma;
+        result.p = std::min(1., 2. * normalCDF(-std::abs(result.z)));
+    }
+
+    return result;
+}
+
+stats::TestResult stats::proportionTest(std::size_t successes_a, std::size_t n_a,  //
+                                        std::size_t successes_b, std::size_t n_b)
+{
+    TestResult result{0., 0., 1., 0.};
+    if (n_a == 0 or n_b == 0)
+        return result;
+
+    const double p1 = double(successes_a) / n_a;
+    const double p2 = double(successes_b) / n_b;
+    const double p = double(successes_a + successes_b) / (n_a + n_b);
+
+    result.statistic = p1 - p2;
+    result.effect = 2. * std::asin(std::sqrt(p1)) - 2. * std::asin(std::sqrt(p2));
+
+    const double se = std::sqrt(p * (1. - p) * (1. / n_a + 1. / n_b));
+    if (se > 0.)
+    {
+        result.z = result.statistic / se;
+        result.p = std::min(1., 2. * normalCDF(-std::abs(result.z)));
+    }
+
+    return result;
+}
+
+///
+/// stats::Moments
+///
+
+void stats::Moments::add(double value)
+{
+    n_++;
+    if (n_ == 1)
+    {
+        min_ = value;
+        max_ = value;
+    }
+    else
+    {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    const double delta = value - mean_;
+    mean_ += delta / n_;
+    m2_ += delta * (value - mean_);
+}
+
+std::size_t stats::Moments::getCount() const
+{
+    return n_;
+}
+
+double stats::Moments::getMean() const
+{
+    return (n_ > 0) ? mean_ : NaN;
+}
+
+double stats::Moments::getVariance() const
+{
+    return (n_ > 1) ? m2_ / (n_ - 1) : 0.;
+}
+
+double stats::Moments::getStandardDeviation() const
+{
+    return std::sqrt(getVariance());
+}
+
+double stats::Moments::getMin() const
+{
+    return (n_ > 0) ? min_ : NaN;
+}
+
+double stats::Moments::getMax() const
+{
+    return (n_ > 0) ? max_ : NaN;
+}
+
+///
+/// stats::P2Quantile
+///
+
+stats::P2Quantile::P2Quantile(double q) : q_(std::max(0., std::min(1., q)))
+{
+    pos_ = {0., 1., 2., 3., 4.};
+    desired_ = {0., 2. * q_, 4. * q_, 2. + 2. * q_, 4.};
+    inc_ = {0., q_ / 2., q_, (1. + q_) / 2., 1.};
+}
+
+void stats::P2Quantile::add(double value)
+{
+    // Store the first five values directly, as the initial marker heights.
+    if (count_ < 5)
+    {
+        height_[count_++] = value;
+        std::sort(height_.begin(), height_.begin() + count_);
+        return;
+    }
+
+    count_++;
+
+    // Find the cell the value falls in, extending the extreme markers if needed.
+    std::size_t k;
+    if (value < height_[0])
+    {
+        height_[0] = value;
+        k = 0;
+    }
+    else if (value >= height_[4])
+    {
+        height_[4] = value;
+        k = 3;
+    }
+    else
+    {
+        k = 0;
+        while (value >= height_[k + 1])
+            k++;
+    }
+
+    for (std::size_t i = k + 1; i < 5; ++i)
+        pos_[i] += 1.;
+
+    for (std::size_t i = 0; i < 5; ++i)
+        desired_[i] += inc_[i];
+
+    // Adjust the heights of the middle markers if they are off their desired positions.
+    for (std::size_t i = 1; i < 4; ++i)
+    {
+        const double d = desired_[i] - pos_[i];
+        if ((d >= 1. and pos_[i + 1] - pos_[i] > 1.) or (d <= -1. and pos_[i - 1] - pos_[i] < -1.))
+        {
+            const double s = (d > 0.) ? 1. : -1.;
+
+            // Piecewise-parabolic prediction of the new height.
+            const double parabolic =
+                height_[i] + s / (pos_[i + 1] - pos_[i - 1]) *
+                                 ((pos_[i] - pos_[i - 1] + s) * (height_[i + 1] - height_[i]) /
+                                      (pos_[i + 1] - pos_[i]) +
+                                  (pos_[i + 1] - pos_[i] - s) * (height_[i] - height_[i - 1]) /
+                                      (pos_[i] - pos_[i - 1]));
+
+            if (height_[i - 1] < parabolic and parabolic < height_[i + 1])
+                height_[i] = parabolic;
+            else
+            {
+                // Fall back to linear prediction if the parabola is not monotonic.
+                const std::size_t j = (s > 0.) ? i + 1 : i - 1;
+                height_[i] += s * (height_[j] - height_[i]) / (pos_[j] - pos_[i]);
+            }
+
+            pos_[i] += s;
+        }
+    }
+}
+
+std::size_t stats::P2Quantile::getCount() const
+{
+    return count_;
+}
+
+double stats::P2Quantile::getQuantile() const
+{
+    return q_;
+}
+
+double stats::P2Quantile::get() const
+{
+    if (count_ < 5)
+        return quantileSorted(std::vector<double>(height_.begin(), height_.begin() + count_), q_);
+
+    return height_[2];
+}
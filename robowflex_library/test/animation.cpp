@@ -0,0 +1,93 @@
+/* Author: Zachary Kingston */
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <robowflex_library/io/animation.h>
+#include <robowflex_library/tf.h>
+
+using namespace robowflex;
+
+namespace
+{
+    RobotPose makePose(double x, double angle)
+    {
+        RobotPose pose = RobotPose::Identity();
+        pose.translate(Eigen::Vector3d{x, 0.5 * x, 1.});
+        pose.rotate(Eigen::AngleAxisd(angle, Eigen::Vector3d::UnitZ()));
+
+        return pose;
+    }
+
+    void expectNear(const RobotPose &actual, const RobotPose &expected, double tolerance)
+    {
+        for (std::size_t i = 0; i < 3; ++i)
+            EXPECT_NEAR(actual.translation()[i], expected.translation()[i], tolerance);
+
+        const auto &a = TF::getPoseRotation(actual);
+        const auto &b = TF::getPoseRotation(expected);
+        for (std::size_t i = 0; i < 4; ++i)
+            EXPECT_NEAR(a.coeffs()[i], b.coeffs()[i], tolerance);
+    }
+}  // namespace
+
+TEST(AnimationWriter, deltaRoundTrip)
+{
+    const std::vector<std::string> links = {"still", "drifting", "moving", "between"};
+    const std::size_t interval = 4;
+    const std::size_t frames = 3 * interval + 1;
+    const double tolerance = 1e-4;
+
+    // "drifting" moves less than the tolerance each frame, but more over many frames. "between" is at the
+    // same pose on every keyframe, and only moves in the deltas between them.
+    std::vector<RobotPoseVector> animation;
+    for (std::size_t i = 0; i < frames; ++i)
+        animation.push_back({makePose(0., 0.),                           //
+                             makePose(0.5 * tolerance * i, 0.),          //
+                             makePose(0.1 * i, 0.05 * i),                //
+                             makePose((i % interval) ? 0.3 : 0., (i % interval) ? 0.2 : 0.)});
+
+    const auto &file =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.anim"))
+            .string();
+
+    {
+        IO::AnimationWriter writer(file, links, 30., interval, tolerance);
+        ASSERT_TRUE(writer.isOpen());
+
+        for (const auto &poses : animation)
+            ASSERT_TRUE(writer.addFrame(1. / 30., poses));
+
+        ASSERT_EQ(writer.getFrameCount(), frames);
+        ASSERT_TRUE(writer.close());
+    }
+
+    IO::AnimationReader reader(file);
+    ASSERT_TRUE(reader.isOpen());
+    ASSERT_DOUBLE_EQ(reader.getFPS(), 30.);
+    ASSERT_EQ(reader.getLinks(), links);
+
+    std::size_t read = 0;
+    double duration;
+    while (reader.next(duration))
+    {
+        ASSERT_LT(read, frames);
+        ASSERT_DOUBLE_EQ(duration, 1. / 30.);
+
+        // Unmoved links are within the tolerance, plus single precision rounding.
+        for (std::size_t j = 0; j < links.size(); ++j)
+            expectNear(reader.getPose(j), animation[read][j], tolerance + 1e-6);
+
+        read++;
+    }
+
+    boost::filesystem::remove(file);
+    ASSERT_EQ(read, frames);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,159 @@
+/* Author: Zachary Kingston */
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <robowflex_library/benchmarking.h>
+
+using namespace robowflex;
+
+namespace
+{
+    /** Keeps each dataset dumped to it. */
+    class Collector : public PlanDataSetOutputter
+    {
+    public:
+        void dump(const PlanDataSet &results) override
+        {
+            dumped.emplace_back(results);
+        }
+
+        std::vector<PlanDataSet> dumped;
+    };
+
+    PlanDataPtr makeRun(const std::string &query, const std::map<std::string, PlannerMetric> &metrics)
+    {
+        auto run = std::make_shared<PlanData>();
+        run->query.name = query;
+        run->time = 1.;
+        run->success = true;
+        run->metrics = metrics;
+
+        return run;
+    }
+
+    PlanDataSetPtr makeDataSet(const std::string &name, const std::vector<PlanDataPtr> &runs)
+    {
+        std::vector<PlanDataSetPtr> datasets;
+        for (const auto &run : runs)
+        {
+            auto dataset = std::make_shared<PlanDataSet>();
+            dataset->name = name;
+            dataset->time = 1.;
+            dataset->allowed_time = 5.;
+            dataset->trials = 1;
+            dataset->threads = 1;
+            dataset->enforced_single_thread = false;
+            dataset->run_till_timeout = false;
+            dataset->query_names.emplace_back(run->query.name);
+            dataset->addDataPoint(run->query.name, run);
+
+            datasets.emplace_back(dataset);
+        }
+
+        return PlanDataSetLoader::merge(datasets, name);
+    }
+
+    std::string getTemporaryPath()
+    {
+        return (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    }
+
+    std::size_t countRuns(const PlanDataSet &dataset)
+    {
+        std::size_t runs = 0;
+        for (const auto &query : dataset.data)
+            runs += query.second.size();
+
+        return runs;
+    }
+}  // namespace
+
+TEST(PlanDataSetLoader, mergeMismatchedMetrics)
+{
+    // Runs with different metrics, e.g., from datasets with and without warm-up or counters.
+    const auto &merged = makeDataSet("merged", {makeRun("query", {{"length", 0}, {"a", 1}}),
+                                                makeRun("query", {{"length", 2.5}, {"b", true}})});
+
+    const auto &prefix = getTemporaryPath();
+    OMPLPlanDataSetOutputter output(prefix);
+    output.dump(*merged);
+
+    const auto &file = prefix + "_merged.log";
+    const auto &loaded = PlanDataSetLoader::fromOMPLLogFile(file);
+    boost::filesystem::remove(file);
+
+    ASSERT_TRUE(loaded);
+    const auto &runs = loaded->data.at("query");
+    ASSERT_EQ(runs.size(), 2u);
+
+    // Missing metrics stay missing, and a metric that is a double in any run is a double in all.
+    ASSERT_EQ(runs[0]->metrics.size(), 2u);
+    ASSERT_EQ(runs[0]->metrics.count("b"), 0u);
+    ASSERT_DOUBLE_EQ(boost::get<double>(runs[0]->metrics.at("length")), 0.);
+    ASSERT_EQ(boost::get<int>(runs[0]->metrics.at("a")), 1);
+
+    ASSERT_EQ(runs[1]->metrics.size(), 2u);
+    ASSERT_EQ(runs[1]->metrics.count("a"), 0u);
+    ASSERT_DOUBLE_EQ(boost::get<double>(runs[1]->metrics.at("length")), 2.5);
+    ASSERT_TRUE(boost::get<bool>(runs[1]->metrics.at("b")));
+}
+
+TEST(PlanDataSetLoader, mergeFilesShards)
+{
+    // Two logs of the same dataset, of 5 and 4 runs, over two queries.
+    std::vector<std::string> files;
+    for (std::size_t n : {5, 4})
+    {
+        std::vector<PlanDataPtr> runs;
+        for (std::size_t i = 0; i < n; ++i)
+            runs.emplace_back(makeRun((i % 2) ? "odd" : "even", {{"index", int(i)}}));
+
+        const auto &prefix = getTemporaryPath();
+        files.emplace_back(prefix + "_experiment.log");
+
+        OMPLPlanDataSetOutputter output(prefix);
+        output.dump(*makeDataSet("experiment", runs));
+    }
+
+    Collector shards;
+    const std::size_t total = PlanDataSetLoader::mergeFiles(files, shards, 3, 1);
+
+    Collector whole;
+    const std::size_t whole_total = PlanDataSetLoader::mergeFiles(files, whole, 0, 1);
+
+    for (const auto &file : files)
+        boost::filesystem::remove(file);
+
+    // Shards are split within logs, so every shard is full but the last.
+    ASSERT_EQ(total, 9u);
+    ASSERT_EQ(shards.dumped.size(), 3u);
+
+    double time = 0.;
+    for (std::size_t i = 0; i < shards.dumped.size(); ++i)
+    {
+        const auto &shard = shards.dumped[i];
+        ASSERT_EQ(shard.name, "experiment_shard" + std::to_string(i));
+        ASSERT_EQ(countRuns(shard), 3u);
+        ASSERT_DOUBLE_EQ(shard.allowed_time, 5.);
+
+        time += shard.time;
+    }
+
+    // Totals are only counted once for each log.
+    ASSERT_DOUBLE_EQ(time, 9.);
+
+    // Without sharding, all runs are merged into one dataset.
+    ASSERT_EQ(whole_total, 9u);
+    ASSERT_EQ(whole.dumped.size(), 1u);
+    ASSERT_EQ(whole.dumped[0].name, "experiment");
+    ASSERT_EQ(countRuns(whole.dumped[0]), 9u);
+    ASSERT_DOUBLE_EQ(whole.dumped[0].time, 9.);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,98 @@
+/* Author: Zachary Kingston */
+
+#include <gtest/gtest.h>
+
+#include <robowflex_library/detail/ur5.h>
+#include <robowflex_library/io/broadcaster.h>
+#include <robowflex_library/util.h>
+
+using namespace robowflex;
+
+namespace
+{
+    /** Stands in for TF listeners, keeping each batch of transforms sent. */
+    struct Subscriber
+    {
+        std::vector<std::vector<geometry_msgs::TransformStamped>> batches;
+        std::vector<geometry_msgs::TransformStamped> statics;
+
+        void attach(IO::RobotBroadcaster &broadcaster)
+        {
+            broadcaster.setTransformPublishers(
+                [&](const std::vector<geometry_msgs::TransformStamped> &transforms) {
+                    batches.emplace_back(transforms);
+                },
+                [&](const std::vector<geometry_msgs::TransformStamped> &transforms) {
+                    statics = transforms;
+                });
+        }
+    };
+}  // namespace
+
+TEST(RobotBroadcaster, sendsChangedTransforms)
+{
+    auto ur5 = std::make_shared<UR5Robot>();
+    ASSERT_TRUE(ur5->initialize());
+
+    const std::size_t n = ur5->getModelConst()->getLinkModels().size();
+    const std::vector<double> start = {0.0677, -0.8235, 0.9860, -0.1624, 0.0678, 0.0};
+
+    ur5->setGroupState("manipulator", start);
+
+    IO::RobotBroadcaster broadcaster(ur5);
+    broadcaster.setKeepAlive(1e6);
+
+    Subscriber subscriber;
+    subscriber.attach(broadcaster);
+
+    // Every transform is sent the first time, as one batch.
+    broadcaster.update();
+    ASSERT_EQ(subscriber.batches.size(), 1u);
+    ASSERT_EQ(subscriber.batches[0].size(), n);
+
+    // Nothing is sent if the robot has not moved.
+    broadcaster.update();
+    ASSERT_EQ(subscriber.batches.size(), 1u);
+
+    // Moving only the last joint still sends every transform, so they all have the same stamp.
+    auto moved = start;
+    moved[5] = 1.;
+    ur5->setGroupState("manipulator", moved);
+
+    broadcaster.update();
+    ASSERT_EQ(subscriber.batches.size(), 2u);
+    ASSERT_EQ(subscriber.batches[1].size(), n);
+
+    // Static transforms are sent once, as a set, when they change.
+    broadcaster.addStaticTransform("a", "world", "a");
+    broadcaster.addStaticTransform("b", "world", "b");
+    ASSERT_EQ(subscriber.statics.size(), 2u);
+
+    broadcaster.removeStaticTransform("a");
+    ASSERT_EQ(subscriber.statics.size(), 1u);
+    ASSERT_EQ(subscriber.statics[0].child_frame_id, "b");
+
+    broadcaster.update();
+    ASSERT_EQ(subscriber.batches.size(), 2u);
+
+    const auto &stats = broadcaster.getStats();
+    ASSERT_EQ(stats.updates, 4u);
+    ASSERT_EQ(stats.batches, 2u);
+    ASSERT_EQ(stats.sent, 2 * n);
+    ASSERT_EQ(stats.skipped, 2 * n);
+
+    // With no keep alive period, every transform is sent every update.
+    broadcaster.setKeepAlive(0);
+    broadcaster.update();
+    ASSERT_EQ(subscriber.batches.size(), 3u);
+    ASSERT_EQ(subscriber.batches[2].size(), n);
+}
+
+int main(int argc, char **argv)
+{
+    // Startup ROS
+    ROS ros(argc, argv);
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
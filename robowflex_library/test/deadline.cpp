@@ -0,0 +1,108 @@
+/* Author: Zachary Kingston */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <robowflex_library/io.h>
+#include <robowflex_library/planning.h>
+#include <robowflex_library/robot.h>
+#include <robowflex_library/util.h>
+
+using namespace robowflex;
+
+namespace
+{
+    /** Stands in for a planner that overshoots, sleeping in every call. */
+    class SleepingPlanner : public Planner
+    {
+    public:
+        SleepingPlanner(const RobotPtr &robot) : Planner(robot, "sleeping")
+        {
+        }
+
+        planning_interface::MotionPlanResponse
+        plan(const SceneConstPtr & /*scene*/,
+             const planning_interface::MotionPlanRequest & /*request*/) override
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(sleep));
+
+            planning_interface::MotionPlanResponse response;
+            response.error_code_.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+            return response;
+        }
+
+        std::vector<std::string> getPlannerConfigs() const override
+        {
+            return {};
+        }
+
+        std::map<std::string, ProgressProperty>
+        getProgressProperties(const SceneConstPtr & /*scene*/,
+                              const planning_interface::MotionPlanRequest & /*request*/) const override
+        {
+            return {{"sleep", [this] { return std::to_string(sleep); }}};
+        }
+
+        std::atomic<double> sleep{0.};  ///< Time to sleep for in plan().
+    };
+
+    double timeSince(const boost::posix_time::ptime &start)
+    {
+        return IO::getSeconds(start, IO::getDate());
+    }
+}  // namespace
+
+TEST(DeadlinePlanner, returnsByDeadlineAfterMiss)
+{
+    const double deadline = 0.2;
+    const double slack = 0.1;
+
+    auto robot = std::make_shared<Robot>("deadline");
+    auto sleeping = std::make_shared<SleepingPlanner>(robot);
+
+    DeadlinePlanner planner(sleeping);
+    planner.setDeadline(deadline);
+
+    planning_interface::MotionPlanRequest request;
+
+    // Within the deadline, the wrapped planner's result is returned.
+    ASSERT_EQ(planner.plan(nullptr, request).error_code_.val, moveit_msgs::MoveItErrorCodes::SUCCESS);
+    ASSERT_EQ(planner.getProgressProperties(nullptr, request).size(), 1u);
+
+    // Miss the deadline, leaving a late job running well past the deadline of the next run.
+    sleeping->sleep = 10 * deadline;
+    auto start = IO::getDate();
+    ASSERT_EQ(planner.plan(nullptr, request).error_code_.val, moveit_msgs::MoveItErrorCodes::TIMED_OUT);
+    ASSERT_LT(timeSince(start), deadline + slack);
+
+    // Each step of the next run still returns by the deadline.
+    sleeping->sleep = 0.;
+
+    start = IO::getDate();
+    planner.preRun(nullptr, request);
+    ASSERT_LT(timeSince(start), deadline + slack);
+
+    start = IO::getDate();
+    ASSERT_TRUE(planner.getProgressProperties(nullptr, request).empty());
+    ASSERT_LT(timeSince(start), deadline + slack);
+
+    start = IO::getDate();
+    ASSERT_EQ(planner.plan(nullptr, request).error_code_.val, moveit_msgs::MoveItErrorCodes::TIMED_OUT);
+    ASSERT_LT(timeSince(start), deadline + slack);
+
+    // Once the late job is done, results are returned again.
+    std::this_thread::sleep_for(std::chrono::duration<double>(10 * deadline));
+    ASSERT_EQ(planner.plan(nullptr, request).error_code_.val, moveit_msgs::MoveItErrorCodes::SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+    // Startup ROS
+    ROS ros(argc, argv);
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
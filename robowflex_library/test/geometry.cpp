@@ -0,0 +1,85 @@
+/* Author: Zachary Kingston */
+
+#include <gtest/gtest.h>
+
+#include <robowflex_library/geometry.h>
+
+using namespace robowflex;
+
+namespace
+{
+    /** An octahedron, as triangles of vertices. */
+    EigenSTL::vector_Vector3d getOctahedron(double r)
+    {
+        EigenSTL::vector_Vector3d vertices;
+        for (const double x : {-r, r})
+            for (const double y : {-r, r})
+                for (const double z : {-r, r})
+                {
+                    vertices.emplace_back(x, 0., 0.);
+                    vertices.emplace_back(0., y, 0.);
+                    vertices.emplace_back(0., 0., z);
+                }
+
+        return vertices;
+    }
+
+    /** Boxes, spheres, and cylinders are checked with vectorized kernels, meshes by the body. */
+    std::vector<GeometryPtr> getGeometries()
+    {
+        return {Geometry::makeBox(0.2, 0.4, 0.6),  //
+                Geometry::makeSphere(0.3),         //
+                Geometry::makeCylinder(0.2, 0.5),  //
+                Geometry::makeMesh(getOctahedron(0.3))};
+    }
+}  // namespace
+
+TEST(Geometry, batchContainsMatchesPoints)
+{
+    random_numbers::RandomNumberGenerator rng(1);
+
+    // Points around all geometries, so each contains some but not all of them.
+    const std::size_t n = 1000;
+    Eigen::Matrix3Xd points(3, n);
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < 3; ++j)
+            points(j, i) = rng.uniformReal(-0.4, 0.4);
+
+    for (const auto &geometry : getGeometries())
+    {
+        Geometry::ContainsMask mask;
+        const std::size_t count = geometry->contains(points, mask);
+
+        ASSERT_EQ(static_cast<std::size_t>(mask.size()), n);
+        ASSERT_EQ(count, static_cast<std::size_t>(mask.count()));
+        ASSERT_GT(count, 0u);
+        ASSERT_LT(count, n);
+
+        for (std::size_t i = 0; i < n; ++i)
+            ASSERT_EQ(mask[i], geometry->contains(Eigen::Vector3d(points.col(i))))
+                << ShapeType::toString(geometry->getType()) << " point " << i;
+    }
+}
+
+TEST(Geometry, batchSampleIsContained)
+{
+    random_numbers::RandomNumberGenerator rng(1);
+
+    const std::size_t n = 1000;
+    for (const auto &geometry : getGeometries())
+    {
+        Eigen::Matrix3Xd points;
+        ASSERT_EQ(geometry->sample(n, points, rng), n);
+        ASSERT_EQ(static_cast<std::size_t>(points.cols()), n);
+
+        for (std::size_t i = 0; i < n; ++i)
+            ASSERT_TRUE(geometry->contains(Eigen::Vector3d(points.col(i))))
+                << ShapeType::toString(geometry->getType()) << " point " << i;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,85 @@
+/* Author: Zachary Kingston */
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <robowflex_library/detail/ur5.h>
+#include <robowflex_library/io/hdf5.h>
+#include <robowflex_library/trajectory.h>
+#include <robowflex_library/util.h>
+
+using namespace robowflex;
+
+TEST(HDF5Writer, trajectoryRoundTrip)
+{
+    auto ur5 = std::make_shared<UR5Robot>();
+    ASSERT_TRUE(ur5->initialize());
+
+    const std::vector<std::vector<double>> waypoints = {{0.0677, -0.8235, 0.9860, -0.1624, 0.0678, 0.0},
+                                                        {0.1, -0.8, 0.9, -0.1, 0.1, 0.1},
+                                                        {0.2, -0.7, 0.8, -0.2, 0.2, 0.2}};
+
+    Trajectory trajectory(ur5, "manipulator");
+    for (const auto &waypoint : waypoints)
+    {
+        ur5->setGroupState("manipulator", waypoint);
+        trajectory.addSuffixWaypoint(*ur5->getScratchStateConst(), 0.5);
+    }
+
+    const auto &file =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.hdf5"))
+            .string();
+
+    {
+        IO::HDF5Writer writer(file);
+        writer.addTrajectory("trajectory", trajectory);
+
+        // States without joints are not written.
+        writer.addStates("states", {}, {{}});
+    }
+
+    std::vector<std::string> names;
+    std::vector<std::vector<std::string>> keys;
+    TrajectoryPtr loaded;
+    {
+        IO::HDF5File reader(file);
+        names = reader.getTrajectoryNames();
+        keys = reader.getKeys();
+        loaded = reader.getTrajectory("trajectory", ur5);
+    }
+
+    boost::filesystem::remove(file);
+
+    ASSERT_EQ(names, std::vector<std::string>{"trajectory"});
+    for (const auto &key : keys)
+        ASSERT_NE(key.front(), "states");
+
+    ASSERT_TRUE(loaded);
+    ASSERT_EQ(loaded->getTrajectoryConst()->getGroupName(), "manipulator");
+    ASSERT_EQ(loaded->getNumWaypoints(), waypoints.size());
+
+    const auto &expected = trajectory.getMessage().joint_trajectory;
+    const auto &actual = loaded->getMessage().joint_trajectory;
+    ASSERT_EQ(actual.joint_names, expected.joint_names);
+    ASSERT_EQ(actual.points.size(), expected.points.size());
+
+    for (std::size_t i = 0; i < actual.points.size(); ++i)
+    {
+        ASSERT_EQ(actual.points[i].positions.size(), expected.points[i].positions.size());
+        for (std::size_t j = 0; j < actual.points[i].positions.size(); ++j)
+            ASSERT_DOUBLE_EQ(actual.points[i].positions[j], expected.points[i].positions[j]);
+
+        ASSERT_NEAR(actual.points[i].time_from_start.toSec(),  //
+                    expected.points[i].time_from_start.toSec(), 1e-9);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // Startup ROS
+    ROS ros(argc, argv);
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+/* Author: Zachary Kingston */
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <robowflex_library/statistics.h>
+
+using namespace robowflex;
+
+TEST(Statistics, summarize)
+{
+    const std::vector<double> values{5., 1., 4., 2., 3.};
+    const auto &summary = stats::summarize(values);
+
+    ASSERT_EQ(summary.n, 5);
+    ASSERT_DOUBLE_EQ(summary.mean, 3.);
+    ASSERT_DOUBLE_EQ(summary.stddev, std::sqrt(2.5));
+    ASSERT_DOUBLE_EQ(summary.min, 1.);
+    ASSERT_DOUBLE_EQ(summary.q25, 2.);
+    ASSERT_DOUBLE_EQ(summary.median, 3.);
+    ASSERT_DOUBLE_EQ(summary.max, 5.);
+    ASSERT_DOUBLE_EQ(stats::quantile(values, 0.9), 4.6);
+}
+
+TEST(Statistics, empty)
+{
+    const auto &summary = stats::summarize({});
+
+    ASSERT_EQ(summary.n, 0);
+    ASSERT_TRUE(std::isnan(summary.mean));
+    ASSERT_TRUE(std::isnan(summary.median));
+}
+
+TEST(Statistics, fitPowerLaw)
+{
+    const std::vector<double> x{1., 2., 4., 8., 16.};
+    std::vector<double> y;
+    for (const auto &v : x)
+        y.emplace_back(3. * v * v);
+
+    const auto &fit = stats::fitPowerLaw(x, y);
+    ASSERT_NEAR(fit.exponent, 2., 1e-9);
+    ASSERT_NEAR(fit.coefficient, 3., 1e-9);
+    ASSERT_NEAR(fit.r2, 1., 1e-9);
+}
+
+TEST(Statistics, mannWhitneyU)
+{
+    const auto &result = stats::mannWhitneyU({1., 2., 3., 4., 5.}, {6., 7., 8., 9., 10.});
+    ASSERT_NEAR(result.statistic, 0., 1e-9);
+    ASSERT_NEAR(result.effect, -1., 1e-9);
+    ASSERT_NEAR(result.p, 0.01218, 1e-4);
+
+    const auto &same = stats::mannWhitneyU({1., 1., 1.}, {1., 1., 1.});
+    ASSERT_NEAR(same.p, 1., 1e-9);
+}
+
+TEST(Statistics, proportionTest)
+{
+    const auto &result = stats::proportionTest(45, 50, 30, 50);
+    ASSERT_NEAR(result.statistic, 0.3, 1e-9);
+    ASSERT_NEAR(result.z, 3.4641, 1e-4);
+    ASSERT_NEAR(result.p, 0.000532, 1e-5);
+    ASSERT_GT(result.effect, 0.);
+}
+
+TEST(Statistics, Moments)
+{
+    const std::vector<double> values{2., 4., 4., 4., 5., 5., 7., 9.};
+
+    stats::Moments moments;
+    for (const auto &value : values)
+        moments.add(value);
+
+    ASSERT_EQ(moments.getCount(), values.size());
+    ASSERT_NEAR(moments.getMean(), stats::mean(values), 1e-9);
+    ASSERT_NEAR(moments.getVariance(), stats::variance(values), 1e-9);
+    ASSERT_NEAR(moments.getMin(), 2., 1e-9);
+    ASSERT_NEAR(moments.getMax(), 9., 1e-9);
+}
+
+TEST(Statistics, P2Quantile)
+{
+    std::vector<double> values;
+    stats::P2Quantile median(0.5), tail(0.95);
+    for (std::size_t i = 0; i < 10000; ++i)
+    {
+        // Deterministic permutation of [0, 1).
+        const double value = ((i * 7919) % 10000) / 10000.;
+        values.emplace_back(value);
+        median.add(value);
+        tail.add(value);
+    }
+
+    ASSERT_NEAR(median.get(), stats::quantile(values, 0.5), 0.01);
+    ASSERT_NEAR(tail.get(), stats::quantile(values, 0.95), 0.01);
+
+    stats::P2Quantile small(0.5);
+    small.add(3.);
+    small.add(1.);
+    small.add(2.);
+    ASSERT_NEAR(small.get(), 2., 1e-9);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+/* Author: Zachary Kingston */
+
+#ifndef ROBOWFLEX_MOVEGROUP_RECORDER_
+#define ROBOWFLEX_MOVEGROUP_RECORDER_
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <robowflex_library/class_forward.h>
+
+#include <robowflex_movegroup/services.h>
+
+namespace robowflex
+{
+    namespace movegroup
+    {
+        /** \cond IGNORE */
+        ROBOWFLEX_CLASS_FORWARD(ActionRecorder);
+        /** \endcond */
+
+        /** \class robowflex::movegroup::ActionRecorderPtr
+            \brief A shared pointer wrapper for robowflex::movegroup::ActionRecorder. */
+
+        /** \class robowflex::movegroup::ActionRecorderConstPtr
+            \brief A const shared pointer wrapper for robowflex::movegroup::ActionRecorder. */
+
+        /** \brief Records move group actions to disk in a compact binary format.
+         *  Recording an action only places it in an in-memory ring buffer, so the recorder can keep up with
+         *  high-rate move group traffic. A background thread serializes buffered actions and appends them to
+         *  `actions.bin` in the output directory. Scenes are stored once per unique scene, keyed by a hash
+         *  of their contents, in the `scenes` subdirectory; actions planned in an unchanged scene only
+         *  reference it. The robot moves between actions, so the robot state of a scene is not part of
+         *  it, and is stored with each action instead. If the writer falls behind and the buffer fills, the
+         *  oldest buffered actions are dropped rather than stalling the recording thread.
+         */
+        class ActionRecorder
+        {
+        public:
+            /** \brief Statistics of recording.
+             */
+            struct Stats
+            {
+                std::size_t recorded{0};          ///< Number of actions recorded.
+                std::size_t dropped{0};           ///< Number of actions dropped as the buffer was full.
+                std::size_t written{0};           ///< Number of actions written to disk.
+                std::size_t scenes{0};            ///< Number of unique scenes written to disk.
+                std::size_t duplicate_scenes{0};  ///< Number of scenes not written as they were unchanged.
+            };
+
+            /** \brief Constructor. Actions are appended to any actions already recorded in \a directory.
+             *  \param[in] directory Directory to write actions to.
+             *  \param[in] capacity Number of actions that can be buffered before they are written.
+             */
+            ActionRecorder(const std::string &directory, std::size_t capacity = 1024);
+
+            /** \brief Destructor. Writes all buffered actions.
+             */
+            ~ActionRecorder();
+
+            // non-copyable
+            ActionRecorder(ActionRecorder const &) = delete;
+            void operator=(ActionRecorder const &) = delete;
+
+            /** \brief Record an action.
+             *  \param[in] action Action to record.
+             *  \return True if the action was buffered without dropping an older action.
+             */
+            bool record(MoveGroupHelper::Action action);
+
+            /** \brief Get a callback for MoveGroupHelper::setResultCallback() that records all actions.
+             *  \return The result callback.
+             */
+            MoveGroupHelper::ResultCallback getCallback();
+
+            /** \brief Waits until all buffered actions have been written.
+             */
+            void flush();
+
+            /** \brief Get statistics of recording.
+             *  \return The recording statistics.
+             */
+            Stats getStats() const;
+
+            /** \brief Load all actions recorded in a directory.
+             *  \param[in] directory Directory actions were recorded in.
+             *  \param[in] robot Robot to load scenes with.
+             *  \param[out] actions Loaded actions. Actions planned in the same scene with the same robot
+             *  state share a scene.
+             *  \return True on success, false on failure.
+             */
+            static bool load(const std::string &directory, const RobotPtr &robot,
+                             std::vector<MoveGroupHelper::Action> &actions);
+
+        private:
+            /** \brief Write buffered actions until the recorder is destroyed. Run on the writer thread.
+             */
+            void run();
+
+            /** \brief Write an action, and its scene if it has not been written before.
+             *  \param[in] action Action to write.
+             */
+            void write(const MoveGroupHelper::Action &action);
+
+            const std::string directory_;  ///< Directory to write actions to.
+            std::ofstream out_;            ///< Output stream for actions.
+            std::set<uint64_t> scenes_;    ///< Hashes of scenes written. Only used by the writer thread.
+
+            std::vector<MoveGroupHelper::Action> buffer_;  ///< Ring buffer of recorded actions.
+            std::size_t head_{0};                          ///< Index of the oldest buffered action.
+            std::size_t count_{0};                         ///< Number of buffered actions.
+            std::size_t active_{0};                        ///< Number of actions being written.
+            bool done_{false};                             ///< True if the writer thread should stop.
+            Stats stats_;                                  ///< Statistics of recording.
+            mutable std::mutex mutex_;                     ///< Mutex for the buffer and statistics.
+            std::condition_variable cv_;                   ///< Notified when the buffer changes.
+            std::thread thread_;                           ///< Writer thread.
+        };
+    }  // namespace movegroup
+}  // namespace robowflex
+
+#endif
@@ -5,15 +5,21 @@
 #include <robowflex_library/log.h>
 #include <robowflex_library/util.h>
 
+#include <robowflex_movegroup/recorder.h>
 #include <robowflex_movegroup/services.h>
 
 using namespace robowflex;
 
 /* \file tapedeck.cpp
  * An example script that shows how to use MoveGroupHelper. Here, a callback is
- * installed so that every motion plan issued to MoveGroup is saved to disk as a
- * YAML file. This is useful for collecting and replaying motion planning
- * requests that are done over the course of an experiment.
+ * installed so that every motion plan issued to MoveGroup is saved to disk.
+ * This is useful for collecting and replaying motion planning requests that are
+ * done over the course of an experiment. By default, plans are recorded with
+ * robowflex::movegroup::ActionRecorder, which keeps up with high-rate traffic
+ * and stores each unique scene once. With the `yaml` argument, each plan is
+ * instead saved as its own YAML file.
+ *
+ * Usage: tapedeck [yaml]
  */
 
 // Output a captured action to a YAML file.
@@ -33,12 +39,30 @@ int main(int argc, char **argv)
     // Startup ROS
     ROS ros(argc, argv);
 
+    const auto &args = ros.getArgs();
+    const bool yaml = args.size() > 1 and args[1] == "yaml";
+
+    // Record actions into the tapedeck directory in the background. Created before the helper, so it
+    // outlives the helper's callbacks.
+    movegroup::ActionRecorderPtr recorder;
+    if (not yaml)
+        recorder = std::make_shared<movegroup::ActionRecorder>("~/robowflex_tapedeck/");
+
     // Create helper
     movegroup::MoveGroupHelper helper;
 
     // Setup callback function
-    helper.setResultCallback(callback);
+    if (recorder)
+        helper.setResultCallback(recorder->getCallback());
+    else
+        helper.setResultCallback(callback);
 
     // Wait until killed
     ros.wait();
+
+    if (recorder)
+    {
+        const auto &stats = recorder->getStats();
+        RBX_INFO("Recorded %s actions with %s unique scenes", stats.recorded, stats.scenes);
+    }
 }
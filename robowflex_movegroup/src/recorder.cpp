@@ -0,0 +1,378 @@
+/* Author: Zachary Kingston */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>  // for std::rename
+#include <cstring>
+#include <map>
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+
+#include <ros/serialization.h>
+
+#include <robowflex_library/io.h>
+#include <robowflex_library/log.h>
+
+#include <robowflex_movegroup/recorder.h>
+
+using namespace robowflex;
+using namespace robowflex::movegroup;
+
+namespace
+{
+    const std::string ACTIONS{"actions.bin"};  // File actions are appended to.
+    const std::string SCENES{"scenes"};        // Subdirectory unique scenes are written to.
+    const char MAGIC[] = "RBXTAPE2";           // Header of the actions file.
+    const std::size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+
+    /** Get the file a scene with a hash is stored in. */
+    boost::filesystem::path getSceneFile(const std::string &directory, uint64_t hash)
+    {
+        return boost::filesystem::path(directory) / SCENES / (boost::format("%016x.scene") % hash).str();
+    }
+
+    /** Serialize a message into a buffer. */
+    template <typename T>
+    std::vector<uint8_t> serializeMessage(const T &msg)
+    {
+        std::vector<uint8_t> buffer(ros::serialization::serializationLength(msg));
+
+        ros::serialization::OStream stream(buffer.data(), buffer.size());
+        ros::serialization::serialize(stream, msg);
+        return buffer;
+    }
+
+    /** Fowler-Noll-Vo hash of a buffer, which is stable between runs and platforms. */
+    uint64_t hashBuffer(const std::vector<uint8_t> &buffer)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (const auto &byte : buffer)
+        {
+            hash ^= byte;
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    /** Read the entire contents of a file into a buffer. */
+    bool readBuffer(const std::string &file, std::vector<uint8_t> &buffer)
+    {
+        std::ifstream in(file, std::ios::binary);
+        if (not in)
+            return false;
+
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    }
+}  // namespace
+
+///
+/// ActionRecorder
+///
+
+ActionRecorder::ActionRecorder(const std::string &directory, std::size_t capacity)
+  : directory_(IO::resolvePackage(directory)), buffer_(std::max<std::size_t>(capacity, 1))
+{
+    boost::filesystem::create_directories(boost::filesystem::path(directory_) / SCENES);
+
+    // Scenes written by previous recordings do not need to be written again.
+    for (boost::filesystem::directory_iterator it(boost::filesystem::path(directory_) / SCENES);
+         it != boost::filesystem::directory_iterator(); ++it)
+    {
+        const auto &stem = it->path().stem().string();
+        if (it->path().extension() == ".scene" and stem.size() == 16 and
+            std::all_of(stem.begin(), stem.end(), ::isxdigit))
+            scenes_.emplace(std::stoull(stem, nullptr, 16));
+    }
+
+    const auto &file = boost::filesystem::path(directory_) / ACTIONS;
+    const bool exists = boost::filesystem::exists(file) and boost::filesystem::file_size(file) > 0;
+
+    // Do not append to a recording in another format.
+    std::string magic(MAGIC, MAGIC_SIZE);
+    if (exists)
+    {
+        std::ifstream in(file.string(), std::ios::binary);
+        in.read(&magic[0], MAGIC_SIZE);
+    }
+
+    if (magic.compare(0, MAGIC_SIZE, MAGIC, MAGIC_SIZE) != 0)
+    {
+        RBX_ERROR("`%s` is a recording of actions in another format", file.string());
+        out_.setstate(std::ios::failbit);
+    }
+    else
+    {
+        out_.open(file.string(), std::ios::binary | std::ios::app);
+        if (not out_)
+            RBX_ERROR("Failed to open `%s` for writing", file.string());
+        else if (not exists)
+            out_.write(MAGIC, MAGIC_SIZE);
+    }
+
+    thread_ = std::thread([this] { run(); });
+}
+
+ActionRecorder::~ActionRecorder()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+
+    cv_.notify_all();
+    thread_.join();
+
+    if (stats_.dropped)
+        RBX_WARN("Dropped %s of %s recorded actions", stats_.dropped, stats_.recorded);
+}
+
+bool ActionRecorder::record(MoveGroupHelper::Action action)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    stats_.recorded++;
+
+    bool dropped = false;
+    if (count_ == buffer_.size())
+    {
+        // Overwrite the oldest buffered action.
+        head_ = (head_ + 1) % buffer_.size();
+        count_--;
+
+        stats_.dropped++;
+        dropped = true;
+    }
+
+    buffer_[(head_ + count_) % buffer_.size()] = std::move(action);
+    count_++;
+
+    cv_.notify_all();
+    return not dropped;
+}
+
+MoveGroupHelper::ResultCallback ActionRecorder::getCallback()
+{
+    return [this](MoveGroupHelper::Action &action) {
+        // MoveGroupHelper discards the action after the callback, so it can be moved.
+        record(std::move(action));
+    };
+}
+
+void ActionRecorder::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return count_ == 0 and active_ == 0; });
+}
+
+ActionRecorder::Stats ActionRecorder::getStats() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ActionRecorder::run()
+{
+    std::vector<MoveGroupHelper::Action> batch;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        cv_.wait(lock, [&] { return count_ > 0 or done_; });
+        if (count_ == 0)
+            break;
+
+        // Take all buffered actions at once, so recording is only blocked for the moves.
+        for (std::size_t i = 0; i < count_; ++i)
+            batch.emplace_back(std::move(buffer_[(head_ + i) % buffer_.size()]));
+
+        head_ = (head_ + count_) % buffer_.size();
+        active_ = count_;
+        count_ = 0;
+
+        lock.unlock();
+        for (const auto &action : batch)
+            write(action);
+
+        out_.flush();
+
+        lock.lock();
+        stats_.written += batch.size();
+        active_ = 0;
+        batch.clear();
+
+        cv_.notify_all();
+    }
+}
+
+void ActionRecorder::write(const MoveGroupHelper::Action &action)
+{
+    if (not out_)
+        return;
+
+    moveit_msgs::PlanningScene scene_msg;
+    if (action.scene)
+        scene_msg = action.scene->getMessage();
+
+    // The robot moves between actions, so its state is stored with each action rather than in the scene.
+    // Otherwise, nearly every action would have a new scene.
+    moveit_msgs::RobotState state;
+    std::swap(state, scene_msg.robot_state);
+
+    const auto &scene = serializeMessage(scene_msg);
+    const uint64_t hash = hashBuffer(scene);
+
+    if (scenes_.emplace(hash).second)
+    {
+        // Write to a temporary file first, and then move it over the output.
+        const auto &file = getSceneFile(directory_, hash).string();
+        const auto &temporary = file + ".tmp";
+
+        std::ofstream scene_out(temporary, std::ios::binary);
+        scene_out.write(reinterpret_cast<const char *>(scene.data()), scene.size());
+        scene_out.close();
+
+        if (not scene_out or std::rename(temporary.c_str(), file.c_str()) != 0)
+            RBX_ERROR("Failed to write scene `%s`", file);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        stats_.scenes++;
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stats_.duplicate_scenes++;
+    }
+
+    const uint8_t success = action.success;
+    const uint32_t size = ros::serialization::serializationLength(action.id) +
+                          sizeof(hash) + sizeof(success) + sizeof(action.time) +
+                          ros::serialization::serializationLength(state) +
+                          ros::serialization::serializationLength(action.request) +
+                          ros::serialization::serializationLength(action.trajectory);
+
+    std::vector<uint8_t> record(sizeof(size) + size);
+    std::memcpy(record.data(), &size, sizeof(size));
+
+    ros::serialization::OStream stream(record.data() + sizeof(size), size);
+    ros::serialization::serialize(stream, action.id);
+    ros::serialization::serialize(stream, hash);
+    ros::serialization::serialize(stream, success);
+    ros::serialization::serialize(stream, action.time);
+    ros::serialization::serialize(stream, state);
+    ros::serialization::serialize(stream, action.request);
+    ros::serialization::serialize(stream, action.trajectory);
+
+    out_.write(reinterpret_cast<const char *>(record.data()), record.size());
+}
+
+bool ActionRecorder::load(const std::string &directory, const RobotPtr &robot,
+                          std::vector<MoveGroupHelper::Action> &actions)
+{
+    const auto &resolved = IO::resolvePackage(directory);
+    const auto &file = (boost::filesystem::path(resolved) / ACTIONS).string();
+
+    std::vector<uint8_t> buffer;
+    if (not readBuffer(file, buffer))
+    {
+        RBX_ERROR("Failed to open `%s`", file);
+        return false;
+    }
+
+    if (buffer.size() < MAGIC_SIZE or std::memcmp(buffer.data(), MAGIC, MAGIC_SIZE) != 0)
+    {
+        RBX_ERROR("`%s` is not a recording of actions", file);
+        return false;
+    }
+
+    // Scene messages without robot state, and scenes with robot state, by the hashes of both.
+    std::map<uint64_t, moveit_msgs::PlanningScene> scene_msgs;
+    std::map<std::pair<uint64_t, uint64_t>, ScenePtr> scenes;
+
+    std::size_t offset = MAGIC_SIZE;
+    while (offset < buffer.size())
+    {
+        uint32_t size;
+        if (offset + sizeof(size) > buffer.size())
+            break;
+
+        std::memcpy(&size, buffer.data() + offset, sizeof(size));
+        offset += sizeof(size);
+
+        // A truncated action was being written when the recording stopped.
+        if (offset + size > buffer.size())
+            break;
+
+        MoveGroupHelper::Action action;
+        moveit_msgs::RobotState state;
+        uint64_t hash;
+        uint8_t success;
+
+        try
+        {
+            ros::serialization::IStream stream(buffer.data() + offset, size);
+            ros::serialization::deserialize(stream, action.id);
+            ros::serialization::deserialize(stream, hash);
+            ros::serialization::deserialize(stream, success);
+            ros::serialization::deserialize(stream, action.time);
+            ros::serialization::deserialize(stream, state);
+            ros::serialization::deserialize(stream, action.request);
+            ros::serialization::deserialize(stream, action.trajectory);
+        }
+        catch (ros::serialization::StreamOverrunException &e)
+        {
+            RBX_ERROR("Invalid action in `%s`", file);
+            return false;
+        }
+
+        offset += size;
+        action.success = success;
+
+        auto mit = scene_msgs.find(hash);
+        if (mit == scene_msgs.end())
+        {
+            const auto &scene_file = getSceneFile(resolved, hash).string();
+
+            std::vector<uint8_t> scene_buffer;
+            moveit_msgs::PlanningScene scene_msg;
+
+            if (not readBuffer(scene_file, scene_buffer))
+            {
+                RBX_ERROR("Failed to open `%s`", scene_file);
+                return false;
+            }
+
+            try
+            {
+                ros::serialization::IStream stream(scene_buffer.data(), scene_buffer.size());
+                ros::serialization::deserialize(stream, scene_msg);
+            }
+            catch (ros::serialization::StreamOverrunException &e)
+            {
+                RBX_ERROR("Failed to load scene `%s`", scene_file);
+                return false;
+            }
+
+            mit = scene_msgs.emplace(hash, scene_msg).first;
+        }
+
+        const auto &key = std::make_pair(hash, hashBuffer(serializeMessage(state)));
+        auto it = scenes.find(key);
+        if (it == scenes.end())
+        {
+            auto scene_msg = mit->second;
+            scene_msg.robot_state = state;
+
+            auto scene = std::make_shared<Scene>(robot);
+            scene->useMessage(scene_msg);
+
+            it = scenes.emplace(key, scene).first;
+        }
+
+        action.scene = it->second;
+        actions.emplace_back(std::move(action));
+    }
+
+    return true;
+}
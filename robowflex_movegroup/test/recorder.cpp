@@ -0,0 +1,119 @@
+/* Author: Zachary Kingston */
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <robowflex_library/detail/ur5.h>
+#include <robowflex_library/geometry.h>
+#include <robowflex_library/scene.h>
+#include <robowflex_library/tf.h>
+#include <robowflex_library/util.h>
+
+#include <robowflex_movegroup/recorder.h>
+
+using namespace robowflex;
+using namespace robowflex::movegroup;
+
+namespace
+{
+    MoveGroupHelper::Action makeAction(const std::string &id, const ScenePtr &scene)
+    {
+        MoveGroupHelper::Action action;
+        action.id = id;
+        action.scene = scene;
+        action.request.group_name = "manipulator";
+        action.success = true;
+        action.time = 1.;
+
+        return action;
+    }
+}  // namespace
+
+TEST(ActionRecorder, recordAndLoad)
+{
+    auto ur5 = std::make_shared<UR5Robot>();
+    ASSERT_TRUE(ur5->initialize());
+
+    auto scene = std::make_shared<Scene>(ur5);
+    scene->updateCollisionObject("cylinder", Geometry::makeCylinder(0.025, 0.1),
+                                 TF::createPoseXYZ(-0.270, 0.42, 1.1572));
+
+    // The robot moves between actions in the same scene.
+    const std::vector<std::vector<double>> states = {{0.0677, -0.8235, 0.9860, -0.1624, 0.0678, 0.0},
+                                                     {0.1, -0.8, 0.9, -0.1, 0.1, 0.1},
+                                                     {0.2, -0.7, 0.8, -0.2, 0.2, 0.2}};
+
+    std::vector<MoveGroupHelper::Action> recorded;
+    for (std::size_t i = 0; i < states.size(); ++i)
+    {
+        auto moved = scene->deepCopy();
+        moved->getCurrentState().setJointGroupPositions("manipulator", states[i]);
+        recorded.emplace_back(makeAction("goal" + std::to_string(i), moved));
+    }
+
+    // Changing the world is a new scene.
+    auto changed = scene->deepCopy();
+    changed->updateCollisionObject("box", Geometry::makeBox(0.1, 0.1, 0.1), TF::createPoseXYZ(0.5, 0., 0.5));
+    recorded.emplace_back(makeAction("goal" + std::to_string(states.size()), changed));
+
+    const auto &directory =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+
+    {
+        ActionRecorder recorder(directory);
+        for (const auto &action : recorded)
+            ASSERT_TRUE(recorder.record(action));
+
+        recorder.flush();
+
+        const auto &stats = recorder.getStats();
+        ASSERT_EQ(stats.written, recorded.size());
+        ASSERT_EQ(stats.scenes, 2u);
+        ASSERT_EQ(stats.duplicate_scenes, 2u);
+    }
+
+    std::vector<MoveGroupHelper::Action> loaded;
+    ASSERT_TRUE(ActionRecorder::load(directory, ur5, loaded));
+
+    const std::size_t scene_files =
+        std::distance(boost::filesystem::directory_iterator(boost::filesystem::path(directory) / "scenes"),
+                      boost::filesystem::directory_iterator());
+    boost::filesystem::remove_all(directory);
+
+    // Each unique scene is written once.
+    ASSERT_EQ(scene_files, 2u);
+
+    ASSERT_EQ(loaded.size(), recorded.size());
+    for (std::size_t i = 0; i < loaded.size(); ++i)
+    {
+        ASSERT_EQ(loaded[i].id, recorded[i].id);
+        ASSERT_EQ(loaded[i].request.group_name, "manipulator");
+        ASSERT_TRUE(loaded[i].success);
+        ASSERT_TRUE(loaded[i].scene->hasObject("cylinder"));
+    }
+
+    // The robot state of each action is kept.
+    for (std::size_t i = 0; i < states.size(); ++i)
+    {
+        std::vector<double> state;
+        loaded[i].scene->getCurrentStateConst().copyJointGroupPositions("manipulator", state);
+
+        ASSERT_EQ(state.size(), states[i].size());
+        for (std::size_t j = 0; j < state.size(); ++j)
+            ASSERT_NEAR(state[j], states[i][j], 1e-9);
+
+        ASSERT_FALSE(loaded[i].scene->hasObject("box"));
+    }
+
+    ASSERT_TRUE(loaded.back().scene->hasObject("box"));
+}
+
+int main(int argc, char **argv)
+{
+    // Startup ROS
+    ROS ros(argc, argv);
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -82,6 +82,22 @@ namespace robowflex
                                 const planning_interface::MotionPlanRequest &request,  //
                                 bool force = false) const;
 
+            /** \brief Get the progress properties of the planner. In addition to the properties the OMPL
+             *  planner provides, adds properties that are cheap to compute for any planner, as they are read
+             *  from counters and the problem definition rather than the planner's graph:
+             *  - `valid states INTEGER` and `invalid states INTEGER`, the results of state validity checks.
+             *    Only given if the context uses MoveIt's default state validity checker, which is replaced
+             *    by a counting one until the next plan() finishes.
+             *  - `valid motions INTEGER` and `invalid motions INTEGER`, the results of motion checks.
+             *  - `solution cost REAL`, the cost of the best solution found so far, or NaN.
+             *  - `first solution time REAL`, the time from the start of the next plan() until the first
+             *    solution, or NaN. Exact for planners that report intermediate solutions (OMPL 1.3 and
+             *    later), otherwise only as precise as the rate the properties are read at.
+             *  Counters start from zero when the properties are created.
+             *  \param[in] scene A planning scene for the same \a robot_ to compute the plan in.
+             *  \param[in] request The motion planning request to solve.
+             *  \return The map of progress property names to functions that compute them.
+             */
             std::map<std::string, Planner::ProgressProperty>
             getProgressProperties(const SceneConstPtr &scene,
                                   const planning_interface::MotionPlanRequest &request) const override;
@@ -129,6 +145,10 @@ namespace robowflex
                                                           ///< planning.
 
             PrePlanCallback pre_plan_callback_;  ///< Callback to be called just before planning.
+
+            mutable std::function<void()> start_progress_;   ///< Called right before the next plan().
+            mutable std::function<void()> finish_progress_;  ///< Called after the next plan(), restores
+                                                             ///< the context.
         };
     }  // namespace OMPL
 }  // namespace robowflex
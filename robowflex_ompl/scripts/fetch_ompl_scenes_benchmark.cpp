@@ -2,6 +2,7 @@
 
 #include <robowflex_library/benchmarking.h>
 #include <robowflex_library/builder.h>
+#include <robowflex_library/dataset.h>
 #include <robowflex_library/detail/fetch.h>
 #include <robowflex_library/geometry.h>
 #include <robowflex_library/log.h>
@@ -32,45 +33,17 @@ int main(int argc, char **argv)
     options.metrics = Profiler::WAYPOINTS | Profiler::CORRECT | Profiler::LENGTH;
     Experiment experiment("fetch_scenes", options, 30.0, 2);
 
-    const std::size_t start = 1;
-    const std::size_t end = 10;
-    for (std::size_t i = start; i <= end; i++)
-    {
-        const auto &scene_file =
-            log::format("package://robowflex_library/yaml/fetch_scenes/scene_vicon%1$04d.yaml", i);
-        const auto &request_file =
-            log::format("package://robowflex_library/yaml/fetch_scenes/request%1$04d.yaml", i);
+    // Create the default planner for the Fetch.
+    auto planner = std::make_shared<OMPL::FetchOMPLPipelinePlanner>(fetch);
+    planner->initialize();
 
-        // Create an empty Scene.
-        auto scene = std::make_shared<Scene>(fetch);
-        if (not scene->fromYAMLFile(scene_file))
-        {
-            RBX_ERROR("Failed to read file: %s for scene", scene_file);
-            continue;
-        }
-
-        // Create the default planner for the Fetch.
-        auto planner = std::make_shared<OMPL::FetchOMPLPipelinePlanner>(fetch);
-        planner->initialize();
-
-        // Create an empty motion planning request.
-        auto request = std::make_shared<robowflex::MotionRequestBuilder>(planner, GROUP);
-        if (not request->fromYAMLFile(request_file))
-        {
-            RBX_ERROR("Failed to read file: %s for request", request_file);
-            continue;
-        }
-
-        request->setConfig("PRMstar");
-
-        // Add request
-        experiment.addQuery(log::format("scene%1$04d", i), scene, planner, request);
-    }
-
-    auto dataset = experiment.benchmark(1);
+    // Load all scene and request pairs in the background.
+    DatasetLoader loader(fetch, planner, GROUP);
+    loader.addDirectory("package://robowflex_library/yaml/fetch_scenes", "scene_vicon", "request");
+    loader.setItemCallback([](DatasetLoader::Item &item) { return item.request->setConfig("PRMstar"); });
 
     OMPLPlanDataSetOutputter output("robowflex_fetch_scenes_ompl");
-    output.dump(*dataset);
+    loader.benchmark(experiment, output, 1);
 
     return 0;
 }
@@ -30,31 +30,43 @@ namespace po = boost::program_options;
 static const std::string GROUP = "arm_with_torso";
 static const double TIME = 60.0;
 
-/** \brief Creates a progress callback function to plot the progress property \a field live using
- * GNUPlot.
+/** \brief Creates a progress callback allocator that starts a live GNUPlot plot of the progress property
+ * \a field for each planning run. Only new progress is sent to the plot on each callback.
  */
-Profiler::ProgressCallback getGNUPlotCallback(IO::GNUPlotHelper &plotter, const std::string &field)
+Profiler::ProgressCallbackAllocator getGNUPlotCallbackAllocator(IO::GNUPlotHelper &plotter,
+                                                                const std::string &field)
 {
-    return [&, field](const PlannerPtr &planner,                             //
-                      const SceneConstPtr &scene,                            //
-                      const planning_interface::MotionPlanRequest &request,  //
-                      const PlanData &result) {
-        IO::GNUPlotHelper::TimeSeriesOptions tso;  // Plotting options for time series data
+    return [&, field](const PlannerPtr &planner,   //
+                      const SceneConstPtr &scene,  //
+                      const planning_interface::MotionPlanRequest &request) -> Profiler::ProgressCallback {
+        IO::GNUPlotHelper::LiveTimeSeriesOptions tso;  // Plotting options for time series data
         tso.instance = field;
         tso.title = "Live Profiling";
         tso.x.label = "Time (s)";
         tso.x.min = 0.;
         tso.x.max = TIME;
 
-        // Plot all progress collected so far.
-        const auto &points = result.getProgressPropertiesAsPoints("time REAL", field);
-        tso.points.emplace(field, points);
-        plotter.timeseries(tso);
+        plotter.startLiveTimeseries(tso);
+
+        // Number of progress points already sent to the plot.
+        auto sent = std::make_shared<std::size_t>(0);
+
+        return [&, field, sent](const PlannerPtr &planner,                             //
+                                const SceneConstPtr &scene,                            //
+                                const planning_interface::MotionPlanRequest &request,  //
+                                const PlanData &result) {
+            const auto &points = result.getProgressPropertiesAsPoints("time REAL", field, *sent);
+            *sent = result.progress.size();
+
+            plotter.appendLiveTimeseries(field, field, points);
+        };
     };
 }
 
 /** \brief Get a custom progress property function allocator that extracts the planner data from the
- * underlying OMPL motion planner.
+ * underlying OMPL motion planner. Note that this copies the planner's graph each time it is called, so it
+ * slows down planning as the graph grows. The counters built into OMPL::OMPLInterfacePlanner's progress
+ * properties are much cheaper.
  */
 Profiler::ProgressPropertyAllocator getNumVerticesAllocator()
 {
@@ -196,7 +208,7 @@ int main(int argc, char **argv)
         ("gnuplot,g", po::bool_switch(&gnuplot),                                                         //
          "Enables GNUPlot visualization of the best cost path (if a progress property)")                 //
         ("liveplot,l", po::bool_switch(&live_plotting),                                                  //
-         "Enables live GNUPlot plotting of `best cost` and `num vertices` (if enabled and available).")  //
+         "Enables live GNUPlot plotting of `best cost` and `valid motions` (or `num vertices`).")        //
         ("rviz,v", po::bool_switch(&rviz_enable),                                                        //
          "Enables live visualization of the planning graph through the RViz MarkerArray.")               //
         ("vertices,n", po::bool_switch(&custom_progress),                                                //
@@ -257,14 +269,17 @@ int main(int argc, char **argv)
     tso.x.min = 0.;
     tso.x.max = TIME;
 
-    // Add a custom metric
-    profiler.addProgressAllocator("num vertices INTEGER", getNumVerticesAllocator());
+    // Add a custom progress property. The planner also has built-in properties, such as counts of valid
+    // motions, that are cheaper to compute.
+    const std::string graph_field = (custom_progress) ? "num vertices INTEGER" : "valid motions INTEGER";
+    if (custom_progress)
+        profiler.addProgressAllocator("num vertices INTEGER", getNumVerticesAllocator());
 
     // Add progress callbacks to plot progress data live while planning.
     if (live_plotting)
     {
-        profiler.addProgressCallback(getGNUPlotCallback(gp, "best cost REAL"));
-        profiler.addProgressCallback(getGNUPlotCallback(gp, "num vertices INTEGER"));
+        profiler.addProgressCallbackAllocator(getGNUPlotCallbackAllocator(gp, "best cost REAL"));
+        profiler.addProgressCallbackAllocator(getGNUPlotCallbackAllocator(gp, graph_field));
     }
 
     // Add a callback to visualize the planning graph in RViz.
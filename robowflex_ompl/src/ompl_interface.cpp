@@ -1,6 +1,16 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <typeinfo>
+
+#include <ompl/base/MotionValidator.h>
+
+#include <moveit/ompl_interface/detail/state_validity_checker.h>
 #include <moveit/ompl_interface/model_based_planning_context.h>
 
 #include <robowflex_library/macros.h>
+#include <robowflex_library/constants.h>
 #include <robowflex_library/log.h>
 #include <robowflex_library/io.h>
 #include <robowflex_library/planning.h>
@@ -11,6 +21,80 @@
 
 using namespace robowflex;
 
+namespace
+{
+    /** MoveIt's state validity checker, counting the results of its checks. As it is a MoveIt checker, it can
+     *  replace the checker of a planning context, which MoveIt casts back to its own type. */
+    class CountingStateValidityChecker : public ompl_interface::StateValidityChecker
+    {
+    public:
+        CountingStateValidityChecker(const ompl_interface::ModelBasedPlanningContext *context)
+          : ompl_interface::StateValidityChecker(context)
+        {
+        }
+
+        using ompl_interface::StateValidityChecker::isValid;
+
+        // All other checks are made through these.
+        bool isValid(const ompl::base::State *state, bool verbose) const override
+        {
+            return count(ompl_interface::StateValidityChecker::isValid(state, verbose));
+        }
+
+        bool isValid(const ompl::base::State *state, double &dist, bool verbose) const override
+        {
+            return count(ompl_interface::StateValidityChecker::isValid(state, dist, verbose));
+        }
+
+        mutable std::atomic<std::size_t> valid{0};
+        mutable std::atomic<std::size_t> invalid{0};
+
+    private:
+        bool count(bool result) const
+        {
+            if (result)
+                valid++;
+            else
+                invalid++;
+
+            return result;
+        }
+    };
+
+    /** Time from the start of planning until the first solution. */
+    class FirstSolutionTime
+    {
+    public:
+        /** Start timing, right before planning. */
+        void start()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_ = std::chrono::steady_clock::now();
+            first_ = constants::nan;
+        }
+
+        /** Report that a solution was found, if it is the first. */
+        void report()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (std::isnan(first_))
+                first_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        }
+
+        /** Get the time of the first solution, or NaN. */
+        double get() const
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return first_;
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        std::chrono::steady_clock::time_point start_{std::chrono::steady_clock::now()};
+        double first_{constants::nan};
+    };
+}  // namespace
+
 OMPL::OMPLInterfacePlanner::OMPLInterfacePlanner(const RobotPtr &robot, const std::string &name)
   : Planner(robot, name)
 {
@@ -69,7 +153,17 @@ planning_interface::MotionPlanResponse OMPL::OMPLInterfacePlanner::plan(
     if (pre_plan_callback_)
         pre_plan_callback_(context_, scene, request);
 
+    if (start_progress_)
+        start_progress_();
+
     context_->solve(response);
+
+    if (finish_progress_)
+        finish_progress_();
+
+    start_progress_ = nullptr;
+    finish_progress_ = nullptr;
+
     return response;
 }
 
@@ -83,7 +177,7 @@ std::map<std::string, Planner::ProgressProperty> OMPL::OMPLInterfacePlanner::get
     const auto &planner = ss_->getPlanner();
 
 #if ROBOWFLEX_AT_LEAST_KINETIC
-    return planner->getPlannerProgressProperties();
+    std::map<std::string, Planner::ProgressProperty> ret = planner->getPlannerProgressProperties();
 
     // As in Indigo they are boost::function
 #else
@@ -93,9 +187,74 @@ std::map<std::string, Planner::ProgressProperty> OMPL::OMPLInterfacePlanner::get
         auto function = pair.second;
         ret[pair.first] = [function] { return function(); };
     }
+#endif
 
-    return ret;
+    const auto &si = ss_->getSpaceInformation();
+    const auto &pdef = ss_->getProblemDefinition();
+
+    // Count state validity checks by replacing the context's checker with a counting one, only if it is
+    // MoveIt's plain checker, as a specialized checker cannot be replaced. It is restored after planning.
+    const auto original = si->getStateValidityChecker();
+    if (original and typeid(*original) == typeid(ompl_interface::StateValidityChecker))
+    {
+        auto checker = std::make_shared<CountingStateValidityChecker>(context_.get());
+        si->setStateValidityChecker(checker);
+
+        ret["valid states INTEGER"] = [checker] { return std::to_string(checker->valid.load()); };
+        ret["invalid states INTEGER"] = [checker] { return std::to_string(checker->invalid.load()); };
+
+        finish_progress_ = [si, original] { si->setStateValidityChecker(original); };
+    }
+
+    if (si->getMotionValidator())
+        si->getMotionValidator()->resetMotionCounter();
+
+    // The motion validator is read when called, as it may be allocated when planning is set up.
+    ret["valid motions INTEGER"] = [si] {
+        const auto &mv = si->getMotionValidator();
+        return std::to_string((mv) ? mv->getValidMotionCount() : 0);
+    };
+
+    ret["invalid motions INTEGER"] = [si] {
+        const auto &mv = si->getMotionValidator();
+        return std::to_string((mv) ? mv->getInvalidMotionCount() : 0);
+    };
+
+    ret["solution cost REAL"] = [pdef] {
+        const auto &path = pdef->getSolutionPath();
+        if (not path)
+            return std::to_string(constants::nan);
+
+        const auto &objective = pdef->getOptimizationObjective();
+        return std::to_string((objective) ? path->cost(objective).value() : path->length());
+    };
+
+    // Timed from the start of planning. Planners that report intermediate solutions give the exact time,
+    // otherwise a solution is only seen when the properties are read.
+    auto first = std::make_shared<FirstSolutionTime>();
+    start_progress_ = [first] { first->start(); };
+
+#if ROBOWFLEX_AT_LEAST_MELODIC
+    pdef->setIntermediateSolutionCallback(
+        [first](const ompl::base::Planner *, const std::vector<const ompl::base::State *> &,
+                const ompl::base::Cost) { first->report(); });
+
+    auto restore = finish_progress_;
+    finish_progress_ = [restore, pdef] {
+        pdef->setIntermediateSolutionCallback(nullptr);
+        if (restore)
+            restore();
+    };
 #endif
+
+    ret["first solution time REAL"] = [pdef, first] {
+        if (pdef->hasSolution())
+            first->report();
+
+        return std::to_string(first->get());
+    };
+
+    return ret;
 }
 
 void OMPL::OMPLInterfacePlanner::refreshContext(const SceneConstPtr &scene,